@@ -0,0 +1,89 @@
+#ifdef UMBRAKED_TRACK_ALLOCS
+#include "AllocTracker.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static thread_local AllocPhase currentPhase = ALLOC_PHASE_OTHER;
+
+static const char* ALLOC_PHASE_NAMES[ALLOC_PHASE_COUNT] = {"other", "update", "render"};
+
+AllocTracker& AllocTracker::instance() {
+    static AllocTracker tracker;
+    return tracker;
+}
+
+AllocTracker::AllocTracker() : totalCounts(), totalBytes(), frame(0), dirtyFrames(0) {
+    for (int phase = 0; phase < ALLOC_PHASE_COUNT; phase++) {
+        frameCounts[phase] = 0;
+        frameBytes[phase] = 0;
+    }
+}
+
+AllocPhase AllocTracker::swapPhase(AllocPhase phase) {
+    AllocPhase previous = currentPhase;
+    currentPhase = phase;
+    return previous;
+}
+
+void AllocTracker::count(size_t bytes) {
+    frameCounts[currentPhase].fetch_add(1, std::memory_order_relaxed);
+    frameBytes[currentPhase].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void AllocTracker::endFrame() {
+    Uint64 counts[ALLOC_PHASE_COUNT], bytes[ALLOC_PHASE_COUNT];
+    for (int phase = 0; phase < ALLOC_PHASE_COUNT; phase++) {
+        counts[phase] = frameCounts[phase].exchange(0, std::memory_order_relaxed);
+        bytes[phase] = frameBytes[phase].exchange(0, std::memory_order_relaxed);
+        totalCounts[phase] += counts[phase];
+        totalBytes[phase] += bytes[phase];
+    }
+    if (frame >= ALLOC_WARMUP_FRAMES && counts[ALLOC_PHASE_UPDATE] + counts[ALLOC_PHASE_RENDER] > 0) {
+        if (dirtyFrames < ALLOC_REPORT_LIMIT) {
+            printf("Frame %d allocated: update %llu (%llu bytes), render %llu (%llu bytes)\n", frame,
+                   static_cast<unsigned long long>(counts[ALLOC_PHASE_UPDATE]), static_cast<unsigned long long>(bytes[ALLOC_PHASE_UPDATE]),
+                   static_cast<unsigned long long>(counts[ALLOC_PHASE_RENDER]), static_cast<unsigned long long>(bytes[ALLOC_PHASE_RENDER]));
+        }
+        dirtyFrames++;
+    }
+    frame++;
+}
+
+bool AllocTracker::report() const {
+    printf("Allocations over %d frames:", frame);
+    for (int phase = 0; phase < ALLOC_PHASE_COUNT; phase++) {
+        printf(" %s %llu (%llu bytes)", ALLOC_PHASE_NAMES[phase],
+               static_cast<unsigned long long>(totalCounts[phase]), static_cast<unsigned long long>(totalBytes[phase]));
+    }
+    printf("\n");
+    if (dirtyFrames > 0) printf("FAIL: %d steady-state frames allocated after a %d frame warmup\n", dirtyFrames, ALLOC_WARMUP_FRAMES);
+    return dirtyFrames == 0;
+}
+
+void* operator new(size_t size) {
+    AllocTracker::instance().count(size);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    std::free(memory);
+}
+#endif
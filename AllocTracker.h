@@ -0,0 +1,48 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#ifdef UMBRAKED_TRACK_ALLOCS
+#include <SDL.h>
+#include <atomic>
+#include "Config.h"
+
+enum AllocPhase { ALLOC_PHASE_OTHER, ALLOC_PHASE_UPDATE, ALLOC_PHASE_RENDER, ALLOC_PHASE_COUNT };
+
+class AllocTracker {
+public:
+    static AllocTracker& instance();
+    static AllocPhase swapPhase(AllocPhase phase);
+    void count(size_t bytes);
+    void endFrame();
+    bool report() const;
+private:
+    AllocTracker();
+
+    std::atomic<Uint64> frameCounts[ALLOC_PHASE_COUNT];
+    std::atomic<Uint64> frameBytes[ALLOC_PHASE_COUNT];
+    Uint64 totalCounts[ALLOC_PHASE_COUNT];
+    Uint64 totalBytes[ALLOC_PHASE_COUNT];
+    int frame;
+    int dirtyFrames;
+};
+
+class AllocPhaseScope {
+public:
+    explicit AllocPhaseScope(AllocPhase phase) : previous(AllocTracker::swapPhase(phase)) {}
+    ~AllocPhaseScope() { AllocTracker::swapPhase(previous); }
+private:
+    AllocPhase previous;
+};
+
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+#define ALLOC_PHASE(phase) AllocPhaseScope ALLOC_CONCAT(allocPhase, __LINE__)(phase)
+#define ALLOC_FRAME() AllocTracker::instance().endFrame()
+#define ALLOC_REPORT() AllocTracker::instance().report()
+#else
+#define ALLOC_PHASE(phase) ((void)0)
+#define ALLOC_FRAME() ((void)0)
+#define ALLOC_REPORT() true
+#endif
+
+#endif
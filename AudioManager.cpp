@@ -0,0 +1,188 @@
+#include "AudioManager.h"
+#include <cstdio>
+
+AudioManager::AudioManager() :
+    lowLatency(false), isOpen(false), deferred(false), requestedMusic(nullptr), activeMusic(nullptr), musicPaused(false),
+    frequency(AUDIO_FREQUENCY), chunkSize(AUDIO_CHUNK_SIZE), fallbacks(0), checkedUnderruns(0), windowStart(0), counterFrequency(1),
+    pendingTrigger(0), lastCallback(0), underruns(0), latencyCount(0), latencyTotalUs(0), latencyMaxUs(0) {
+}
+
+bool AudioManager::open(bool lowLatencyMode) {
+    lowLatency = lowLatencyMode;
+    counterFrequency = SDL_GetPerformanceFrequency();
+    return openDevice(lowLatencyMode ? LOW_LATENCY_CHUNK_SIZE : AUDIO_CHUNK_SIZE);
+}
+
+bool AudioManager::openDevice(int chunk) {
+    double musicPosition = -1.0;
+    if (isOpen) {
+#ifdef SDL_MIXER_VERSION_ATLEAST
+#if SDL_MIXER_VERSION_ATLEAST(2, 6, 0)
+        if (activeMusic) musicPosition = Mix_GetMusicPosition(activeMusic);
+#endif
+#endif
+        Mix_SetPostMix(nullptr, nullptr);
+        Mix_CloseAudio();
+        isOpen = false;
+    }
+    if (Mix_OpenAudio(AUDIO_FREQUENCY, AUDIO_S16SYS, AUDIO_CHANNELS, chunk) < 0) {
+        printf("SDL_mixer could not open audio (%d Hz, %d samples)! SDL_mixer Error: %s\n", AUDIO_FREQUENCY, chunk, Mix_GetError());
+        return false;
+    }
+    int actualFrequency = AUDIO_FREQUENCY;
+    Uint16 actualFormat = AUDIO_S16SYS;
+    int actualChannels = AUDIO_CHANNELS;
+    frequency = Mix_QuerySpec(&actualFrequency, &actualFormat, &actualChannels) ? actualFrequency : AUDIO_FREQUENCY;
+
+    chunkSize = chunk;
+    isOpen = true;
+    pendingTrigger = 0;
+    lastCallback = 0;
+    checkedUnderruns = underruns;
+    windowStart = SDL_GetTicks();
+    Mix_SetPostMix(postMix, this);
+    if (activeMusic) {
+        Mix_PlayMusic(activeMusic, -1);
+        if (musicPosition > 0.0) Mix_SetMusicPosition(musicPosition);
+        if (musicPaused) Mix_PauseMusic();
+    }
+    return true;
+}
+
+void AudioManager::close() {
+    if (!isOpen) return;
+    Mix_SetPostMix(nullptr, nullptr);
+    Mix_CloseAudio();
+    isOpen = false;
+    activeMusic = nullptr;
+    requestedMusic = nullptr;
+}
+
+void AudioManager::setLowLatency(bool enabled) {
+    lowLatency = enabled;
+    submit(AUDIO_SET_LOW_LATENCY, nullptr, enabled);
+}
+
+void AudioManager::playSound(Mix_Chunk* sound) {
+    submit(AUDIO_PLAY_SOUND, sound);
+}
+
+void AudioManager::playMusic(Mix_Music* music) {
+    requestedMusic = music;
+    submit(AUDIO_PLAY_MUSIC, music);
+}
+
+void AudioManager::haltMusic() {
+    if (!requestedMusic) return;
+    requestedMusic = nullptr;
+    submit(AUDIO_HALT_MUSIC);
+}
+
+void AudioManager::pauseMusic() {
+    submit(AUDIO_PAUSE_MUSIC);
+}
+
+void AudioManager::resumeMusic() {
+    submit(AUDIO_RESUME_MUSIC);
+}
+
+void AudioManager::submit(AudioCommandType type, void* data, bool flag) {
+    AudioCommand command = {type, data, flag};
+    if (!deferred) {
+        execute(command);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(commandMutex);
+    pendingCommands.push_back(command);
+}
+
+void AudioManager::execute(const AudioCommand& command) {
+    switch (command.type) {
+        case AUDIO_PLAY_SOUND:
+            if (Mix_PlayChannel(-1, static_cast<Mix_Chunk*>(command.data), 0) >= 0) markTrigger();
+            break;
+        case AUDIO_PLAY_MUSIC:
+            activeMusic = static_cast<Mix_Music*>(command.data);
+            musicPaused = false;
+            Mix_PlayMusic(activeMusic, -1);
+            break;
+        case AUDIO_HALT_MUSIC:
+            activeMusic = nullptr;
+            musicPaused = false;
+            Mix_HaltMusic();
+            break;
+        case AUDIO_PAUSE_MUSIC:
+            musicPaused = true;
+            Mix_PauseMusic();
+            break;
+        case AUDIO_RESUME_MUSIC:
+            musicPaused = false;
+            Mix_ResumeMusic();
+            break;
+        case AUDIO_SET_LOW_LATENCY:
+            if (open(command.flag)) break;
+            printf("Falling back to default audio buffer.\n");
+            open(false);
+            break;
+    }
+}
+
+void AudioManager::markTrigger() {
+    Uint64 expected = 0;
+    pendingTrigger.compare_exchange_strong(expected, SDL_GetPerformanceCounter());
+}
+
+void AudioManager::postMix(void* udata, Uint8*, int) {
+    AudioManager* audio = static_cast<AudioManager*>(udata);
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 period = audio->counterFrequency * audio->chunkSize / audio->frequency;
+
+    Uint64 previous = audio->lastCallback.exchange(now);
+    if (previous != 0 && now - previous > period + period / 2) audio->underruns++;
+
+    Uint64 trigger = audio->pendingTrigger.exchange(0);
+    if (trigger != 0 && now >= trigger) {
+        Uint64 latencyUs = (now - trigger + period) * 1000000 / audio->counterFrequency;
+        audio->latencyTotalUs += latencyUs;
+        audio->latencyCount++;
+        Uint64 currentMax = audio->latencyMaxUs;
+        while (latencyUs > currentMax && !audio->latencyMaxUs.compare_exchange_weak(currentMax, latencyUs)) {}
+    }
+}
+
+void AudioManager::update() {
+    {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        runningCommands.swap(pendingCommands);
+    }
+    for (const auto& command : runningCommands) execute(command);
+    runningCommands.clear();
+    if (!isOpen || SDL_GetTicks() - windowStart < AUDIO_UNDERRUN_WINDOW_MS) return;
+    int recent = underruns - checkedUnderruns;
+    checkedUnderruns = underruns;
+    windowStart = SDL_GetTicks();
+    if (recent >= AUDIO_UNDERRUN_LIMIT && chunkSize < AUDIO_CHUNK_SIZE) {
+        printf("Audio underruns detected (%d), growing buffer to %d samples.\n", recent, chunkSize * 2);
+        fallbacks++;
+        if (!openDevice(chunkSize * 2)) openDevice(AUDIO_CHUNK_SIZE);
+    }
+}
+
+AudioStats AudioManager::getStats() const {
+    AudioStats stats;
+    stats.chunkSize = chunkSize;
+    stats.frequency = frequency;
+    stats.underruns = underruns;
+    stats.fallbacks = fallbacks;
+    stats.latencySamples = latencyCount;
+    stats.averageLatencyMs = stats.latencySamples > 0 ? latencyTotalUs / 1000.0 / stats.latencySamples : 0.0;
+    stats.maxLatencyMs = latencyMaxUs / 1000.0;
+    return stats;
+}
+
+void AudioManager::printStats() const {
+    AudioStats stats = getStats();
+    printf("Audio: %d Hz, %d samples, underruns %d, fallbacks %d, latency avg %.1f ms max %.1f ms (%d triggers)\n",
+           stats.frequency, stats.chunkSize, stats.underruns, stats.fallbacks,
+           stats.averageLatencyMs, stats.maxLatencyMs, stats.latencySamples);
+}
@@ -0,0 +1,75 @@
+#ifndef AUDIO_MANAGER_H
+#define AUDIO_MANAGER_H
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "Config.h"
+
+struct AudioStats {
+    int chunkSize;
+    int frequency;
+    int underruns;
+    int fallbacks;
+    int latencySamples;
+    double averageLatencyMs;
+    double maxLatencyMs;
+};
+
+enum AudioCommandType { AUDIO_PLAY_SOUND, AUDIO_PLAY_MUSIC, AUDIO_HALT_MUSIC, AUDIO_PAUSE_MUSIC, AUDIO_RESUME_MUSIC, AUDIO_SET_LOW_LATENCY };
+
+struct AudioCommand {
+    AudioCommandType type;
+    void* data;
+    bool flag;
+};
+
+class AudioManager {
+public:
+    AudioManager();
+    bool open(bool lowLatency);
+    void close();
+    void setLowLatency(bool enabled);
+    bool isLowLatency() const { return lowLatency; }
+    void setDeferred(bool enabled) { deferred = enabled; }
+    void playSound(Mix_Chunk* sound);
+    void playMusic(Mix_Music* music);
+    void haltMusic();
+    void pauseMusic();
+    void resumeMusic();
+    bool isMusicPlaying() const { return requestedMusic != nullptr; }
+    void update();
+    AudioStats getStats() const;
+    void printStats() const;
+private:
+    static void postMix(void* udata, Uint8* stream, int len);
+    bool openDevice(int chunk);
+    void submit(AudioCommandType type, void* data = nullptr, bool flag = false);
+    void execute(const AudioCommand& command);
+    void markTrigger();
+
+    std::atomic<bool> lowLatency;
+    bool isOpen;
+    bool deferred;
+    Mix_Music* requestedMusic;
+    Mix_Music* activeMusic;
+    bool musicPaused;
+    std::mutex commandMutex;
+    std::vector<AudioCommand> pendingCommands;
+    std::vector<AudioCommand> runningCommands;
+    int frequency;
+    int chunkSize;
+    int fallbacks;
+    int checkedUnderruns;
+    Uint32 windowStart;
+    Uint64 counterFrequency;
+    std::atomic<Uint64> pendingTrigger;
+    std::atomic<Uint64> lastCallback;
+    std::atomic<int> underruns;
+    std::atomic<int> latencyCount;
+    std::atomic<Uint64> latencyTotalUs;
+    std::atomic<Uint64> latencyMaxUs;
+};
+
+#endif
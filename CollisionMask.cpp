@@ -0,0 +1,67 @@
+#include "CollisionMask.h"
+#include "Utils.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+
+static Uint64 lowBits(int count) {
+    return count >= 64 ? ~0ULL : (1ULL << count) - 1;
+}
+
+CollisionMask::CollisionMask() : width(0), height(0) {
+}
+
+bool CollisionMask::load(const char* path, int maskWidth, int maskHeight) {
+    width = 0;
+    if (maskWidth <= 0 || maskWidth > COLLISION_MASK_MAX_WIDTH || maskHeight <= 0) return false;
+    SDL_Surface* image = IMG_Load(path);
+    SDL_Surface* surface = image ? SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_RGBA32, 0) : nullptr;
+    if (image) SDL_FreeSurface(image);
+    if (!surface) {
+        printf("Failed to build collision mask for %s! SDL_image Error: %s\n", path, IMG_GetError());
+        return false;
+    }
+
+    rows.assign(maskHeight, 0);
+    flippedRows.assign(maskHeight, 0);
+    SDL_LockSurface(surface);
+    const Uint8* pixels = static_cast<const Uint8*>(surface->pixels);
+    for (int y = 0; y < maskHeight; y++) {
+        int sourceY = std::min((2 * y + 1) * surface->h / (2 * maskHeight), surface->h - 1);
+        const Uint8* row = pixels + sourceY * surface->pitch;
+        for (int x = 0; x < maskWidth; x++) {
+            int sourceX = std::min((2 * x + 1) * surface->w / (2 * maskWidth), surface->w - 1);
+            if (row[sourceX * 4 + 3] < COLLISION_ALPHA_THRESHOLD) continue;
+            rows[y] |= 1ULL << x;
+            flippedRows[y] |= 1ULL << (maskWidth - 1 - x);
+        }
+    }
+    SDL_UnlockSurface(surface);
+    SDL_FreeSurface(surface);
+    width = maskWidth;
+    height = maskHeight;
+    return true;
+}
+
+Uint64 CollisionMask::rowBits(const SDL_Rect& rect, const CollisionMask* mask, bool flip, int y, int left, int right) {
+    if (!mask || !mask->fits(rect)) return lowBits(right - left);
+    const std::vector<Uint64>& source = flip ? mask->flippedRows : mask->rows;
+    return (source[y - rect.y] >> (left - rect.x)) & lowBits(right - left);
+}
+
+bool CollisionMask::overlaps(const SDL_Rect& a, const CollisionMask* maskA, bool flipA,
+                             const SDL_Rect& b, const CollisionMask* maskB, bool flipB) {
+    if (!checkCollision(a, b)) return false;
+    bool solidA = !maskA || !maskA->fits(a);
+    bool solidB = !maskB || !maskB->fits(b);
+    if (solidA && solidB) return true;
+
+    int left = std::max(a.x, b.x);
+    int right = std::min(a.x + a.w, b.x + b.w);
+    int top = std::max(a.y, b.y);
+    int bottom = std::min(a.y + a.h, b.y + b.h);
+    for (int y = top; y < bottom; y++) {
+        if (rowBits(a, maskA, flipA, y, left, right) & rowBits(b, maskB, flipB, y, left, right)) return true;
+    }
+    return false;
+}
@@ -0,0 +1,23 @@
+#ifndef COLLISION_MASK_H
+#define COLLISION_MASK_H
+#include <SDL.h>
+#include <vector>
+#include "Config.h"
+
+class CollisionMask {
+public:
+    CollisionMask();
+    bool load(const char* path, int width, int height);
+    bool fits(const SDL_Rect& rect) const { return width > 0 && rect.w == width && rect.h == height; }
+    static bool overlaps(const SDL_Rect& a, const CollisionMask* maskA, bool flipA,
+                         const SDL_Rect& b, const CollisionMask* maskB, bool flipB);
+private:
+    static Uint64 rowBits(const SDL_Rect& rect, const CollisionMask* mask, bool flip, int y, int left, int right);
+
+    int width;
+    int height;
+    std::vector<Uint64> rows;
+    std::vector<Uint64> flippedRows;
+};
+
+#endif
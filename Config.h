@@ -1,15 +1,18 @@
 #ifndef CONFIG_H
 #define CONFIG_H
+#include "Fixed.h"
 
 constexpr int SCREEN_WIDTH = 800;
 constexpr int SCREEN_HEIGHT = 600;
 constexpr int TILE_SIZE = 32;
 constexpr int PLAYER_WIDTH = 30;
 constexpr int PLAYER_HEIGHT = 45;
-constexpr float JUMP_FORCE = -14.0f;
-constexpr float GRAVITY = 0.5f;
-constexpr float PLAYER_SPEED = 5.0f;
-constexpr float CAMERA_SPEED = 2.0f;
+constexpr Fixed JUMP_FORCE = toFixed(-14);
+constexpr Fixed GRAVITY = fixedRatio(1, 2);
+constexpr Fixed PLAYER_SPEED = toFixed(5);
+constexpr Fixed PLAYER_BULLET_SPEED = toFixed(10);
+constexpr Fixed ENEMY_BULLET_SPEED = toFixed(3);
+constexpr int CAMERA_SPEED = 2;
 constexpr int FONT_SIZE = 48;
 constexpr const char* TITLE_FONT_PATH = "txt/Purisa-BoldOblique.ttf";
 constexpr const char* FONT_PATH = "txt/SVN-Coder's Crux.ttf";
@@ -26,6 +29,7 @@ constexpr const char* ENEMY_BULLET_IMAGE_PATH = "img/enemybullet.png";
 constexpr const char* BACKGROUND_IMAGE_PATH = "img/background.png";
 constexpr const char* LIVE_IMAGE_PATH = "img/live.png";
 constexpr const char* DIE_IMAGE_PATH = "img/die.png";
+constexpr int HEART_TEXTURE_COUNT = 4;
 constexpr const char* SPIKE_IMAGE_PATH = "img/gai.png";
 constexpr const char* HIT_SOUND_PATH = "sound/rung.wav";
 constexpr const char* SHOOT_SOUND_PATH = "sound/shoot.wav";
@@ -33,11 +37,136 @@ constexpr const char* BOOM_SOUND_PATH = "sound/boom.wav";
 constexpr const char* JUMP_SOUND_PATH = "sound/jump.wav";
 constexpr const char* INGAME_SOUND_PATH = "sound/soundingame.wav";
 constexpr const char* MENU_SOUND_PATH = "sound/soundmenu.wav";
+constexpr const char* RUN_LOG_PATH = "runs.log";
+constexpr const char* RUN_INDEX_PATH = "runs.idx";
+constexpr const char* LEGACY_BEST_SCORE_PATH = "best_score.txt";
 constexpr int MAX_JUMP_DISTANCE = TILE_SIZE * 4;
 constexpr int GROUND_HEIGHT = SCREEN_HEIGHT - TILE_SIZE * 3;
+constexpr int PLAYER_START_X = SCREEN_WIDTH / 4;
+constexpr int PLAYER_START_Y = GROUND_HEIGHT - PLAYER_HEIGHT;
 constexpr int MIN_ENEMY_SPAWN_DISTANCE = 300;
+constexpr int ENEMY_TYPE_COUNT = 5;
 constexpr int BULLET_MAX_DISTANCE = 300;
+constexpr int BULLET_WIDTH = 10;
+constexpr int BULLET_HEIGHT = 5;
+constexpr int AUDIO_FREQUENCY = 44100;
+constexpr int AUDIO_CHANNELS = 2;
+constexpr int AUDIO_CHUNK_SIZE = 2048;
+constexpr int LOW_LATENCY_CHUNK_SIZE = 256;
+constexpr int AUDIO_UNDERRUN_LIMIT = 3;
+constexpr unsigned AUDIO_UNDERRUN_WINDOW_MS = 1000;
+constexpr int ENEMY_DETECTION_RANGE = 200;
+constexpr int ENEMY_FULL_RATE_MARGIN = ENEMY_DETECTION_RANGE + TILE_SIZE;
+constexpr int ENEMY_WAKE_MARGIN = SCREEN_WIDTH / 2;
+constexpr int ENEMY_THROTTLED_INTERVAL = 4;
+constexpr int LINE_OF_SIGHT_CACHE_TICKS = 8;
+constexpr int NAV_CLEARANCE = 40;
+constexpr int NAV_BODY_HALF = 15;
+constexpr Fixed NAV_AIR_SPEED_STEP = toFixed(1);
+constexpr int NAV_AIR_SPEED_STEPS = 3;
+constexpr int NAV_MAX_AIR_TICKS = 120;
+constexpr int NAV_MAX_REACH = SCREEN_WIDTH / 4;
+constexpr int NAV_DROP_COST = TILE_SIZE;
+constexpr int NAV_JUMP_COST = TILE_SIZE * 2;
+constexpr int NAV_REPATH_INTERVAL = 15;
+constexpr int GROUND_MIN_Y = TILE_SIZE * 7;
+constexpr int PLATFORM_MIN_Y = TILE_SIZE * 5 + PLAYER_HEIGHT;
+constexpr int REACH_MAX_RISE = TILE_SIZE * 7;
+constexpr int REACH_HEADROOM_STEP = 4;
+constexpr int REACH_MAX_AIR_TICKS = 120;
+constexpr int REACH_ENTRY_BAND = TILE_SIZE * 4;
+constexpr int REACH_EXIT_WIDTH = TILE_SIZE * 5;
+constexpr int REACH_PATCH_STEP = TILE_SIZE * 2;
+constexpr int REACH_MAX_PATCHES = 4;
+constexpr int REACH_PATCH_TRIES = 4;
+constexpr int REACH_BATCH_CHUNKS = 200;
+constexpr int REACH_BATCH_REPORTED_SEEDS = 10;
+constexpr int MENU_IDLE_TIMEOUT_MS = 250;
+constexpr int BACKGROUND_IDLE_TIMEOUT_MS = 1000;
+constexpr int RUN_HISTORY_TOP_COUNT = 10;
+constexpr int RECORDS_SHOWN = 5;
+constexpr int REPLAY_CHECKSUM_INTERVAL = 60;
+constexpr int REPLAY_KEYFRAME_INTERVAL = 300;
+constexpr int REPLAY_SEEK_STEP = 300;
+constexpr int INVINCIBILITY_TICKS = 120;
+constexpr unsigned PROFILE_RING_SIZE = 1u << 16;
+constexpr double PROFILE_HITCH_MS = 25.0;
+constexpr unsigned PROFILE_HITCH_FRAMES_BEFORE = 30;
+constexpr unsigned PROFILE_HITCH_FRAMES_AFTER = 10;
+constexpr unsigned PROFILE_HITCH_COOLDOWN_FRAMES = 300;
+constexpr int PROFILE_CAPTURE_FRAMES = 120;
+constexpr const char* LAST_REPLAY_PATH = "last_run.rpl";
+constexpr int RENDER_MAX_DIVISOR = 4;
+constexpr int RENDER_LOW_DIVISOR = 2;
+constexpr double RENDER_FRAME_BUDGET_MS = 1000.0 / 60;
+constexpr double RENDER_SCALE_DOWN_MS = 20.0;
+constexpr double RENDER_SCALE_UP_MS = 17.5;
+constexpr double RENDER_SCALE_GAP_MS = 100.0;
+constexpr double RENDER_SCALE_SMOOTHING = 0.1;
+constexpr int RENDER_SCALE_SETTLE_FRAMES = 60;
+constexpr int RENDER_SCALE_PROBE_FRAMES = 600;
+constexpr int RENDER_SCALE_MAX_PROBE_FRAMES = 4800;
+constexpr Uint32 RENDER_BENCH_SEED = 12345;
+constexpr Uint32 SELF_CHECK_SEED = 42;
+constexpr int SELF_CHECK_TICKS = 1200;
+constexpr int SELF_CHECK_LEDGE_TILES = 6;
+constexpr int SELF_CHECK_PIT_TILES = 12;
+constexpr int RENDER_BENCH_SCRIPT_TICKS = 1800;
+constexpr int RENDER_GOLDEN_INTERVAL = 300;
+constexpr int RENDER_GOLDEN_CHANNEL_TOLERANCE = 8;
+constexpr double RENDER_GOLDEN_MAX_DIFF_RATIO = 0.001;
+constexpr const char* RENDER_GOLDEN_DIR = "golden";
+constexpr const char* RENDER_BENCH_CSV_PATH = "render_bench.csv";
+constexpr int ENV_GROUND_COLUMNS = 32;
+constexpr float ENV_LIFE_PENALTY = 50.0f;
+constexpr int FRAME_TARGET_RATE = 60;
+constexpr double FRAME_SPIN_MS = 2.0;
+constexpr int FRAME_VSYNC_PROBE_FRAMES = 12;
+constexpr double FRAME_VSYNC_TOLERANCE = 0.8;
+constexpr int PARTICLE_CAPACITY = 32768;
+constexpr float PARTICLE_GRAVITY = 0.15f;
+constexpr float PARTICLE_DRAG = 0.96f;
+constexpr int PROJECTILE_GRID_MARGIN = 256;
+constexpr int PROJECTILE_GRID_WORDS = (SCREEN_WIDTH + 2 * PROJECTILE_GRID_MARGIN) / 64 + 1;
+constexpr int COLLISION_MASK_MAX_WIDTH = 64;
+constexpr int COLLISION_ALPHA_THRESHOLD = 128;
+constexpr size_t TERRAIN_RESERVE_COLUMNS = 64;
+constexpr size_t NAV_RESERVE_NODES = 128;
+constexpr size_t TILE_RESERVE = 2048;
+constexpr size_t BULLET_RESERVE = 256;
+constexpr size_t ENEMY_RESERVE = 64;
+constexpr size_t MENU_BUTTON_RESERVE = 8;
+constexpr size_t REPLAY_RESERVE_TICKS = 60 * 60 * 15;
+constexpr size_t FRAME_ARENA_BYTES = 16 * 1024;
+constexpr int TEXT_CACHE_SIZE = 64;
+constexpr int TEXT_CACHE_MAX_LENGTH = 64;
+constexpr int TEXT_CACHE_EVICT_FRAMES = 120;
+constexpr int RENDER_LIST_COMMANDS = 4096;
+constexpr int RENDER_LIST_TEXT_BYTES = 2048;
+constexpr int ALLOC_WARMUP_FRAMES = 120;
+constexpr int ALLOC_REPORT_LIMIT = 10;
+constexpr int NET_MAX_PACKET = 128;
+constexpr size_t NET_MAX_DELAYED_PACKETS = 1024;
+constexpr int NET_ROLLBACK_WINDOW = 32;
+constexpr int NET_MAX_PREDICTION = 10;
+constexpr int NET_CHECKSUM_HISTORY = 8;
+constexpr Uint32 NET_HELLO_INTERVAL_MS = 100;
+constexpr Uint32 NET_TIMEOUT_MS = 5000;
+constexpr Uint32 NET_LINGER_MS = 1000;
+constexpr Uint16 NET_DEFAULT_PORT = 7777;
+constexpr double PERF_TOLERANCE = 1.25;
+constexpr double PERF_SLACK_US = 25.0;
+constexpr int PERF_MIN_P99_SAMPLES = 100;
+constexpr const char* PERF_BASELINE_PATH = "perf_baseline.csv";
 
 enum GameState { MAIN_MENU, INSTRUCTIONS, RECORDS, OPTIONS, PLAYING, GAME_OVER };
+enum EnemyActivity { ENEMY_ACTIVE, ENEMY_THROTTLED, ENEMY_ASLEEP };
+enum RenderScaleMode { RENDER_SCALE_NATIVE, RENDER_SCALE_DYNAMIC, RENDER_SCALE_LOW };
+enum ParticleEffect { PARTICLE_EXPLOSION, PARTICLE_HIT, PARTICLE_MUZZLE };
+enum ProjectileTeam { TEAM_PLAYER = 1, TEAM_ENEMY = 2 };
+enum InputBit { INPUT_LEFT = 1, INPUT_RIGHT = 2, INPUT_JUMP = 4, INPUT_FIRE = 8 };
+enum NetRole { NET_OFF, NET_HOST, NET_GUEST };
+
+constexpr Uint8 NET_HOST_INPUTS = INPUT_LEFT | INPUT_RIGHT | INPUT_JUMP;
 
 #endif
@@ -0,0 +1,19 @@
+#ifndef COPY_ON_WRITE_H
+#define COPY_ON_WRITE_H
+#include <memory>
+
+template <typename T>
+class CopyOnWrite {
+public:
+    CopyOnWrite() : data(std::make_shared<T>()) {}
+    const T& operator*() const { return *data; }
+    const T* operator->() const { return data.get(); }
+    T& edit() {
+        if (data.use_count() > 1) data = std::make_shared<T>(*data);
+        return *data;
+    }
+private:
+    std::shared_ptr<T> data;
+};
+
+#endif
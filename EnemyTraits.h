@@ -0,0 +1,48 @@
+#ifndef ENEMY_TRAITS_H
+#define ENEMY_TRAITS_H
+#include <array>
+#include <vector>
+#include <type_traits>
+#include "Structs.h"
+#include "Config.h"
+
+struct EnemyTypeInfo {
+    Fixed speed;
+    int width;
+    int height;
+    bool keepsAspect;
+    int shotCooldown;
+    Fixed bulletSpeedBonus;
+    bool chases;
+};
+
+constexpr EnemyTypeInfo ENEMY_TYPES[ENEMY_TYPE_COUNT] = {
+    {fixedRatio(3, 2), 30, 30, false, 60, 0, false},
+    {fixedRatio(3, 2), 30, 30, false, 60, 0, false},
+    {toFixed(2), 30, 30, false, 45, toFixed(1), false},
+    {toFixed(2), 40, 40, true, 45, toFixed(1), true},
+    {toFixed(2), 30, 30, true, 45, toFixed(1), true},
+};
+
+template <int Type>
+struct EnemyTraits {
+    static_assert(Type >= 0 && Type < ENEMY_TYPE_COUNT, "Unknown enemy type");
+    static constexpr Fixed speed = ENEMY_TYPES[Type].speed;
+    static constexpr int shotCooldown = ENEMY_TYPES[Type].shotCooldown;
+    static constexpr Fixed bulletSpeedBonus = ENEMY_TYPES[Type].bulletSpeedBonus;
+    static constexpr bool chases = ENEMY_TYPES[Type].chases;
+};
+
+typedef std::array<std::vector<Enemy>, ENEMY_TYPE_COUNT> EnemyBuckets;
+
+template <typename Function>
+void forEachEnemyType(Function&&, std::integral_constant<int, ENEMY_TYPE_COUNT>) {
+}
+
+template <typename Function, int Type = 0>
+void forEachEnemyType(Function&& function, std::integral_constant<int, Type> = {}) {
+    function(std::integral_constant<int, Type>());
+    forEachEnemyType(function, std::integral_constant<int, Type + 1>());
+}
+
+#endif
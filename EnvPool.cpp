@@ -0,0 +1,112 @@
+#include "EnvPool.h"
+#include "Game.h"
+#include <SDL_image.h>
+#include <algorithm>
+
+EnvPool::EnvPool(int count, int threadCount) :
+    workerCount(0), generation(0), busyWorkers(0), stopping(false),
+    actions(nullptr), observations(nullptr), rewards(nullptr), dones(nullptr) {
+    SDL_Point spriteSizes[ENEMY_TYPE_COUNT] = {};
+    const char* aspectPaths[ENEMY_TYPE_COUNT] = {nullptr, nullptr, nullptr, ENEMY4_IMAGE_PATH, ENEMY5_IMAGE_PATH};
+    for (int type = 0; type < ENEMY_TYPE_COUNT; type++) {
+        if (!aspectPaths[type]) continue;
+        SDL_Surface* surface = IMG_Load(aspectPaths[type]);
+        if (!surface) continue;
+        spriteSizes[type] = {surface->w, surface->h};
+        SDL_FreeSurface(surface);
+    }
+
+    for (int i = 0; i < count; i++) {
+        games.emplace_back(new Game(true));
+        for (int type = 0; type < ENEMY_TYPE_COUNT; type++) games.back()->setEnemySpriteSize(type, spriteSizes[type].x, spriteSizes[type].y);
+        if (i == 0) games.back()->loadCollisionMasks();
+        else games.back()->copyCollisionMasks(*games.front());
+    }
+    lastScores.assign(count, 0);
+    lastLives.assign(count, 0);
+
+    if (threadCount <= 0) threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    workerCount = std::max(1, std::min(threadCount, count));
+    for (int worker = 1; worker < workerCount; worker++) workers.emplace_back(&EnvPool::workerLoop, this, worker);
+}
+
+EnvPool::~EnvPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void EnvPool::reset(int index, Uint32 seed, EnvObservation* observation) {
+    games[index]->reset(seed);
+    lastScores[index] = games[index]->getScore();
+    lastLives[index] = games[index]->getLives();
+    if (observation) games[index]->observe(*observation);
+}
+
+void EnvPool::resetAll(Uint32 baseSeed, EnvObservation* observations) {
+    for (int i = 0; i < size(); i++) reset(i, baseSeed + i, observations ? &observations[i] : nullptr);
+}
+
+void EnvPool::snapshot(int index, GameSnapshot& state) const {
+    games[index]->snapshot(state);
+}
+
+void EnvPool::restore(int index, const GameSnapshot& state, EnvObservation* observation) {
+    games[index]->restore(state);
+    lastScores[index] = games[index]->getScore();
+    lastLives[index] = games[index]->getLives();
+    if (observation) games[index]->observe(*observation);
+}
+
+void EnvPool::step(const Uint8* stepActions, EnvObservation* stepObservations, float* stepRewards, Uint8* stepDones) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        actions = stepActions;
+        observations = stepObservations;
+        rewards = stepRewards;
+        dones = stepDones;
+        busyWorkers = workerCount - 1;
+        generation++;
+    }
+    wake.notify_all();
+    stepRange(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busyWorkers == 0; });
+}
+
+void EnvPool::workerLoop(int worker) {
+    Uint32 seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        stepRange(worker);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        finished.notify_one();
+    }
+}
+
+void EnvPool::stepRange(int worker) {
+    int begin = size() * worker / workerCount;
+    int end = size() * (worker + 1) / workerCount;
+    for (int i = begin; i < end; i++) {
+        Game& game = *games[i];
+        game.step(actions[i]);
+        int score = game.getScore();
+        int lives = game.getLives();
+        rewards[i] = static_cast<float>(score - lastScores[i]) - ENV_LIFE_PENALTY * (lastLives[i] - lives);
+        dones[i] = game.isRunOver();
+        lastScores[i] = score;
+        lastLives[i] = lives;
+        game.observe(observations[i]);
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef ENV_POOL_H
+#define ENV_POOL_H
+#include <SDL.h>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Structs.h"
+#include "Config.h"
+
+class Game;
+struct GameSnapshot;
+
+class EnvPool {
+public:
+    EnvPool(int count, int threadCount = 0);
+    ~EnvPool();
+    int size() const { return static_cast<int>(games.size()); }
+    void reset(int index, Uint32 seed, EnvObservation* observation = nullptr);
+    void resetAll(Uint32 baseSeed, EnvObservation* observations = nullptr);
+    void step(const Uint8* actions, EnvObservation* observations, float* rewards, Uint8* dones);
+    void snapshot(int index, GameSnapshot& state) const;
+    void restore(int index, const GameSnapshot& state, EnvObservation* observation = nullptr);
+private:
+    void workerLoop(int worker);
+    void stepRange(int worker);
+
+    std::vector<std::unique_ptr<Game>> games;
+    std::vector<int> lastScores;
+    std::vector<int> lastLives;
+    std::vector<std::thread> workers;
+    int workerCount;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    Uint32 generation;
+    int busyWorkers;
+    bool stopping;
+    const Uint8* actions;
+    EnvObservation* observations;
+    float* rewards;
+    Uint8* dones;
+};
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef FIXED_H
+#define FIXED_H
+#include <SDL.h>
+
+typedef Sint32 Fixed;
+
+constexpr int FIXED_SHIFT = 8;
+constexpr Fixed FIXED_ONE = 1 << FIXED_SHIFT;
+
+constexpr Fixed toFixed(int value) { return value * FIXED_ONE; }
+constexpr Fixed fixedRatio(int numerator, int denominator) { return numerator * FIXED_ONE / denominator; }
+constexpr int fixedToInt(Fixed value) { return value >> FIXED_SHIFT; }
+
+#endif
@@ -0,0 +1,35 @@
+#include "FrameArena.h"
+#include <cstdarg>
+#include <cstdio>
+
+FrameArena::FrameArena(size_t capacity) : buffer(capacity), used(0), peak(0), overflowed(false) {
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    size_t start = (used + alignment - 1) & ~(alignment - 1);
+    if (start + size > buffer.size()) {
+        if (!overflowed) printf("Frame arena exhausted (%u bytes)\n", static_cast<unsigned>(buffer.size()));
+        overflowed = true;
+        return nullptr;
+    }
+    used = start + size;
+    if (used > peak) peak = used;
+    return buffer.data() + start;
+}
+
+const char* FrameArena::format(const char* pattern, ...) {
+    va_list args;
+    va_start(args, pattern);
+    va_list measure;
+    va_copy(measure, args);
+    int length = vsnprintf(nullptr, 0, pattern, measure);
+    va_end(measure);
+    char* text = length < 0 ? nullptr : static_cast<char*>(allocate(length + 1, 1));
+    if (text) vsnprintf(text, length + 1, pattern, args);
+    va_end(args);
+    return text ? text : "";
+}
+
+void FrameArena::reset() {
+    used = 0;
+}
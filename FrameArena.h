@@ -0,0 +1,20 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+#include <cstddef>
+#include <vector>
+
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity);
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    const char* format(const char* pattern, ...);
+    void reset();
+    size_t getPeak() const { return peak; }
+private:
+    std::vector<char> buffer;
+    size_t used;
+    size_t peak;
+    bool overflowed;
+};
+
+#endif
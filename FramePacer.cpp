@@ -0,0 +1,101 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+FramePacer::FramePacer() :
+    frequency(SDL_GetPerformanceFrequency()), period(0), nextDeadline(0), lastFrameEnd(0),
+    targetRate(FRAME_TARGET_RATE), refreshRate(0), vsyncEffective(false), timerOnly(false),
+    frames(0), missed(0), meanMs(0), m2(0), minMs(0), maxMs(0) {
+}
+
+void FramePacer::configure(SDL_Renderer* renderer, SDL_Window* window, int rate) {
+    targetRate = std::max(0, rate);
+    period = targetRate > 0 ? frequency / targetRate : 0;
+
+    SDL_DisplayMode mode;
+    refreshRate = 0;
+    if (window && SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(window), &mode) == 0) refreshRate = mode.refresh_rate;
+
+    SDL_RendererInfo info;
+    bool vsyncRequested = renderer && SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+    if (vsyncRequested && targetRate == 0) {
+        SDL_RenderSetVSync(renderer, 0);
+        vsyncRequested = false;
+    }
+    vsyncEffective = vsyncRequested && refreshRate > 0 && probeVsync(renderer);
+    printf("Frame pacing: target %s, display %d Hz, vsync %s\n", targetRate ? std::to_string(targetRate).c_str() : "uncapped",
+           refreshRate, vsyncEffective ? "effective" : "off");
+    reset();
+}
+
+bool FramePacer::probeVsync(SDL_Renderer* renderer) {
+    std::vector<double> intervals;
+    SDL_RenderClear(renderer);
+    SDL_RenderPresent(renderer);
+    Uint64 last = SDL_GetPerformanceCounter();
+    for (int i = 0; i < FRAME_VSYNC_PROBE_FRAMES; i++) {
+        SDL_RenderClear(renderer);
+        SDL_RenderPresent(renderer);
+        Uint64 now = SDL_GetPerformanceCounter();
+        intervals.push_back(static_cast<double>(now - last) * 1000.0 / frequency);
+        last = now;
+    }
+    std::sort(intervals.begin(), intervals.end());
+    return intervals[intervals.size() / 2] >= FRAME_VSYNC_TOLERANCE * 1000.0 / refreshRate;
+}
+
+void FramePacer::reset() {
+    nextDeadline = 0;
+    lastFrameEnd = 0;
+}
+
+void FramePacer::endFrame() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    bool vsyncPaced = !timerOnly && vsyncEffective && refreshRate <= targetRate;
+    if (period && !vsyncPaced) {
+        if (!nextDeadline || now > nextDeadline + period) nextDeadline = now;
+        nextDeadline += period;
+        waitUntil(nextDeadline);
+        now = SDL_GetPerformanceCounter();
+    }
+    if (lastFrameEnd) recordInterval(static_cast<double>(now - lastFrameEnd) * 1000.0 / frequency);
+    lastFrameEnd = now;
+}
+
+void FramePacer::waitUntil(Uint64 deadline) const {
+    Uint64 spin = static_cast<Uint64>(FRAME_SPIN_MS * frequency / 1000.0);
+    Uint64 now = SDL_GetPerformanceCounter();
+    while (now + spin < deadline) {
+        Uint32 sleepMs = static_cast<Uint32>((deadline - spin - now) * 1000 / frequency);
+        if (sleepMs == 0) break;
+        SDL_Delay(sleepMs);
+        now = SDL_GetPerformanceCounter();
+    }
+    while (SDL_GetPerformanceCounter() < deadline) {
+    }
+}
+
+void FramePacer::recordInterval(double ms) {
+    frames++;
+    double delta = ms - meanMs;
+    meanMs += delta / frames;
+    m2 += delta * (ms - meanMs);
+    minMs = frames == 1 ? ms : std::min(minMs, ms);
+    maxMs = std::max(maxMs, ms);
+    if (targetRate > 0 && ms > 1500.0 / targetRate) missed++;
+}
+
+FrameStats FramePacer::getStats() const {
+    return {targetRate, refreshRate, vsyncEffective, frames, missed, meanMs,
+            frames > 1 ? std::sqrt(m2 / (frames - 1)) : 0.0, minMs, maxMs};
+}
+
+void FramePacer::printStats() const {
+    FrameStats stats = getStats();
+    if (!stats.frames) return;
+    printf("Frames: %d, interval avg %.3f ms, jitter %.3f ms, min %.3f ms, max %.3f ms, missed %d\n",
+           stats.frames, stats.meanMs, stats.jitterMs, stats.minMs, stats.maxMs, stats.missed);
+}
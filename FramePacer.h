@@ -0,0 +1,49 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+#include <SDL.h>
+#include "Config.h"
+
+struct FrameStats {
+    int targetRate;
+    int refreshRate;
+    bool vsyncEffective;
+    int frames;
+    int missed;
+    double meanMs;
+    double jitterMs;
+    double minMs;
+    double maxMs;
+};
+
+class FramePacer {
+public:
+    FramePacer();
+    void configure(SDL_Renderer* renderer, SDL_Window* window, int targetRate);
+    void reset();
+    void setTimerOnly(bool enabled) { timerOnly = enabled; }
+    void endFrame();
+    bool isVsyncEffective() const { return vsyncEffective; }
+    FrameStats getStats() const;
+    void printStats() const;
+private:
+    bool probeVsync(SDL_Renderer* renderer);
+    void waitUntil(Uint64 deadline) const;
+    void recordInterval(double ms);
+
+    Uint64 frequency;
+    Uint64 period;
+    Uint64 nextDeadline;
+    Uint64 lastFrameEnd;
+    int targetRate;
+    int refreshRate;
+    bool vsyncEffective;
+    bool timerOnly;
+    int frames;
+    int missed;
+    double meanMs;
+    double m2;
+    double minMs;
+    double maxMs;
+};
+
+#endif
@@ -1,5 +1,11 @@
 #include "Game.h"
 #include "Utils.h"
+#include "Replay.h"
+#include "Profiler.h"
+#include "AllocTracker.h"
+#include "TerrainProfile.h"
+#include "RenderBench.h"
+#include "PerfBench.h"
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
@@ -7,276 +13,875 @@
 #include <random>
 #include <algorithm>
 #include <string>
-#include <fstream>
 #include <cstdio>
-
-Game::Game() :
-    window(nullptr), renderer(nullptr), font(nullptr), titleFont(nullptr), scoreFont(nullptr),
-    playerTexture(nullptr), groundTexture(nullptr), floatingTexture(nullptr),
-    enemy1Texture(nullptr), enemy2Texture(nullptr), enemy3Texture(nullptr),
-    enemy4Texture(nullptr), enemy5Texture(nullptr), bulletTexture(nullptr),
-    enemyBulletTexture(nullptr), backgroundTexture(nullptr), spikeTexture(nullptr),
-    hitSound(nullptr), shootSound(nullptr), boomSound(nullptr), jumpSound(nullptr),
-    inGameMusic(nullptr), menuMusic(nullptr),
-    enemy4AspectRatio(1.0f), enemy5AspectRatio(1.0f),
-    gameState(MAIN_MENU), isJumping(false), isOnGround(true),
-    playerFlipped(false), playerVelX(0), playerVelY(0), score(0), bestScore(0),
+#include <thread>
+#include <chrono>
+
+static const char* spritePaths[SPRITE_COUNT] = {
+    BACKGROUND_IMAGE_PATH, GROUND_TILE_PATH, FLOATING_TILE_PATH, SPIKE_IMAGE_PATH,
+    ENEMY1_IMAGE_PATH, ENEMY2_IMAGE_PATH, ENEMY3_IMAGE_PATH, ENEMY4_IMAGE_PATH, ENEMY5_IMAGE_PATH,
+    BULLET_IMAGE_PATH, ENEMY_BULLET_IMAGE_PATH, PLAYER_IMAGE_PATH,
+    LIVE_IMAGE_PATH, LIVE_IMAGE_PATH, LIVE_IMAGE_PATH, DIE_IMAGE_PATH};
+
+Game::Game(bool simulation) :
+    isSpacePressed(false), simulationOnly(simulation), window(nullptr), renderer(nullptr), frameSurface(nullptr), drawCalls(0),
+    gameState(MAIN_MENU), renderedState(MAIN_MENU), needsRedraw(true), paused(false),
+    hasFocus(true), isMinimized(false), isJumping(false), isOnGround(true),
+    playerFlipped(false), playerPosX(0), playerPosY(0), playerVelX(0), playerVelY(0), score(0), bestScore(0),
     cameraX(0), maxPlayerX(0), shootCooldown(0), groundHeight(GROUND_HEIGHT),
-    lastGeneratedX(0), lives(3), invincibilityTimer(0), isInvincible(false),
-    musicOn(true), sfxOn(true), isSpacePressed(false),
-    playerRect{SCREEN_WIDTH / 4, GROUND_HEIGHT - PLAYER_HEIGHT, PLAYER_WIDTH, PLAYER_HEIGHT},
-    gen(std::random_device()()),
-    yDist(200, 400), gapDist(TILE_SIZE * 4, TILE_SIZE * 6), spawnDist(0.0f, 1.0f) {
+    lastGeneratedX(0), lives(3), simulationTick(0), runSeed(0), runHistory(RUN_LOG_PATH, RUN_INDEX_PATH),
+    invincibilityTimer(0), isInvincible(false),
+    musicOn(true), sfxOn(true), renderScale(RENDER_SCALE_DYNAMIC), threadedRendering(true),
+    simulationThreaded(false), quitRequested(false), exitCode(0), heldInput(0), wakeEventType(0), frameArena(FRAME_ARENA_BYTES), frameRate(FRAME_TARGET_RATE),
+    replayMode(REPLAY_OFF), hasCheckpoint(false), replayDesyncTick(-1), spaceTapped(false), seeking(false), showSightLines(false),
+    playerRect{PLAYER_START_X, PLAYER_START_Y, PLAYER_WIDTH, PLAYER_HEIGHT},
+    reachStats(), gen(std::random_device()()) {
+    menuButtons.reserve(MENU_BUTTON_RESERVE);
+    projectiles.setMask(TEAM_PLAYER, &spriteMasks[SPRITE_BULLET]);
+    projectiles.setMask(TEAM_ENEMY, &spriteMasks[SPRITE_ENEMY_BULLET]);
+    for (int type = 0; type < ENEMY_TYPE_COUNT; type++) enemyWidths[type] = ENEMY_TYPES[type].width;
 }
 
 Game::~Game() {
     close();
 }
 
-bool Game::init() {
+bool Game::init(bool headless) {
+    if (headless) {
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+    }
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0 || !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) || TTF_Init() == -1) {
         printf("SDL initialization failed! Error: %s\n", SDL_GetError());
         return false;
     }
 
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
+    if (!audio.open(false)) {
         printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
         return false;
     }
 
-    window = SDL_CreateWindow("Umbraked", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                              SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    if (!window || !renderer) return false;
-
-    font = TTF_OpenFont(FONT_PATH, FONT_SIZE);
-    titleFont = TTF_OpenFont(TITLE_FONT_PATH, 72);
-    scoreFont = TTF_OpenFont("txt/BungeeTint-Regular.ttf", 28);
-    if (!font || !titleFont || !scoreFont) {
-        printf("Failed to load fonts! SDL_ttf Error: %s\n", TTF_GetError());
-        return false;
-    }
-
-    SDL_Surface* surface;
-    surface = IMG_Load(PLAYER_IMAGE_PATH); playerTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(GROUND_TILE_PATH); groundTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(FLOATING_TILE_PATH); floatingTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(ENEMY1_IMAGE_PATH); enemy1Texture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(ENEMY2_IMAGE_PATH); enemy2Texture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(ENEMY3_IMAGE_PATH); enemy3Texture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-
-    surface = IMG_Load(ENEMY4_IMAGE_PATH);
-    enemy4Texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (surface) {
-        enemy4AspectRatio = static_cast<float>(surface->w) / surface->h;
-        SDL_FreeSurface(surface);
+    if (headless) {
+        frameSurface = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_RGBA32);
+        if (frameSurface) renderer = SDL_CreateSoftwareRenderer(frameSurface);
+        if (!renderer) {
+            printf("Software renderer could not be created! SDL_Error: %s\n", SDL_GetError());
+            return false;
+        }
     } else {
-        printf("Failed to load enemy4.png! SDL_Error: %s\n", SDL_GetError());
-        enemy4AspectRatio = 1.0f;
+        window = SDL_CreateWindow("Umbraked", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                  SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        if (!window || !renderer) return false;
+        framePacer.configure(renderer, window, frameRate);
+    }
+    renderScaler.create(renderer);
+    particles.create(PARTICLE_CAPACITY);
+    textCache.create(renderer);
+
+    renderBuffer.create(PARTICLE_CAPACITY * 4);
+
+    resources.create(renderer);
+    fonts[FONT_BODY] = resources.loadFont(FONT_PATH, FONT_SIZE);
+    fonts[FONT_TITLE] = resources.loadFont(TITLE_FONT_PATH, 72);
+    fonts[FONT_SCORE] = resources.loadFont("txt/BungeeTint-Regular.ttf", 28);
+    if (!fonts[FONT_BODY] || !fonts[FONT_TITLE] || !fonts[FONT_SCORE]) return false;
+
+    PROFILE_ZONE("Game::init resources");
+    bool loaded = true;
+    for (int id = 0; id < SPRITE_COUNT; id++) {
+        sprites[id] = resources.loadTexture(spritePaths[id]);
+        loaded = loaded && sprites[id];
+    }
+    for (int type = 0; type < ENEMY_TYPE_COUNT; type++) {
+        const TextureHandle& texture = sprites[SPRITE_ENEMY + type];
+        if (texture) setEnemySpriteSize(type, texture.getWidth(), texture.getHeight());
     }
+    loadCollisionMasks();
 
-    surface = IMG_Load(ENEMY5_IMAGE_PATH);
-    enemy5Texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (surface) {
-        enemy5AspectRatio = static_cast<float>(surface->w) / surface->h;
-        SDL_FreeSurface(surface);
-    } else {
-        printf("Failed to load enemy5.png! SDL_Error: %s\n", SDL_GetError());
-        enemy5AspectRatio = 1.0f;
-    }
-
-    surface = IMG_Load(BULLET_IMAGE_PATH); bulletTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(ENEMY_BULLET_IMAGE_PATH); enemyBulletTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(BACKGROUND_IMAGE_PATH); backgroundTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(SPIKE_IMAGE_PATH); spikeTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-
-    surface = IMG_Load(LIVE_IMAGE_PATH);
-    heartTextures.push_back(SDL_CreateTextureFromSurface(renderer, surface));
-    heartTextures.push_back(SDL_CreateTextureFromSurface(renderer, surface));
-    heartTextures.push_back(SDL_CreateTextureFromSurface(renderer, surface));
-    SDL_FreeSurface(surface);
-    surface = IMG_Load(DIE_IMAGE_PATH);
-    heartTextures.push_back(SDL_CreateTextureFromSurface(renderer, surface));
-    SDL_FreeSurface(surface);
-
-    hitSound = Mix_LoadWAV(HIT_SOUND_PATH);
-    shootSound = Mix_LoadWAV(SHOOT_SOUND_PATH);
-    boomSound = Mix_LoadWAV(BOOM_SOUND_PATH);
-    jumpSound = Mix_LoadWAV(JUMP_SOUND_PATH);
-    inGameMusic = Mix_LoadMUS(INGAME_SOUND_PATH);
-    menuMusic = Mix_LoadMUS(MENU_SOUND_PATH);
+    hitSound = resources.loadSound(HIT_SOUND_PATH);
+    shootSound = resources.loadSound(SHOOT_SOUND_PATH);
+    boomSound = resources.loadSound(BOOM_SOUND_PATH);
+    jumpSound = resources.loadSound(JUMP_SOUND_PATH);
+    inGameMusic = resources.loadMusic(INGAME_SOUND_PATH);
+    menuMusic = resources.loadMusic(MENU_SOUND_PATH);
 
     Mix_VolumeMusic(64);
 
-    if (!playerTexture || !groundTexture || !floatingTexture || !enemy1Texture || !enemy2Texture ||
-        !enemy3Texture || !enemy4Texture || !enemy5Texture || !bulletTexture || !enemyBulletTexture ||
-        !backgroundTexture || !spikeTexture || heartTextures.size() < 4 || !hitSound || !shootSound ||
-        !boomSound || !jumpSound || !inGameMusic || !menuMusic) {
+    if (!loaded || !hitSound || !shootSound || !boomSound || !jumpSound || !inGameMusic || !menuMusic) {
         printf("Failed to load resources!\n");
         return false;
     }
 
-    loadBestScore();
+    runHistory.load();
+    bestScore = runHistory.getBestScore();
     resetGame();
-    if (musicOn) Mix_PlayMusic(menuMusic, -1);
+    if (musicOn) audio.playMusic(menuMusic.get());
 
     return true;
 }
 
 void Game::run() {
-    const int FPS = 60;
-    const int frameDelay = 1000 / FPS;
-    Uint32 frameStart;
-    while (true) {
-        frameStart = SDL_GetTicks();
-        handleEvents();
-        if (gameState == PLAYING) update();
-        updateMusic();
-        render();
-        int frameTime = SDL_GetTicks() - frameStart;
-        if (frameDelay > frameTime) SDL_Delay(frameDelay - frameTime);
+    if (threadedRendering && replayMode != REPLAY_FAST) {
+        runThreaded();
+    } else {
+        runSerial();
     }
+    close();
+    exit(exitCode);
 }
 
-void Game::handleEvents() {
+void Game::runSerial() {
+    while (!quitRequested) {
+        if (replayMode == REPLAY_FAST) {
+            Uint64 start = SDL_GetPerformanceCounter();
+            fastForwardReplay(replay.getTickCount());
+            double seconds = static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+            printf("Simulated %d ticks in %.3f s (%.0f ticks/s)\n", simulationTick, seconds,
+                   seconds > 0 ? simulationTick / seconds : 0.0);
+            finishReplay();
+            continue;
+        }
+        bool simulating = isSimulating();
+        if (!simulating && !needsRedraw && gameState == renderedState) SDL_WaitEventTimeout(NULL, idleTimeout());
+        {
+            PROFILE_ZONE("Game::run");
+            handleEvents();
+            if (quitRequested) break;
+            simulating = advanceFrame();
+            audio.update();
+            if (isFrameDue(simulating)) {
+                render();
+                needsRedraw = false;
+                renderedState = gameState;
+            }
+        }
+        PROFILE_FRAME(simulating);
+        ALLOC_FRAME();
+        if (simulating) framePacer.endFrame();
+        else framePacer.reset();
+    }
+}
+
+void Game::runThreaded() {
+    wakeEventType = SDL_RegisterEvents(1);
+    framePacer.setTimerOnly(true);
+    simulationThreaded = true;
+    audio.setDeferred(true);
+    std::thread simulation(&Game::simulationLoop, this);
+    while (!quitRequested) {
+        if (!renderBuffer.hasFresh()) SDL_WaitEventTimeout(NULL, BACKGROUND_IDLE_TIMEOUT_MS);
+        forwardEvents();
+        audio.update();
+        if (const RenderList* list = renderBuffer.acquire()) submitRenderList(*list);
+    }
+    eventReady.notify_one();
+    simulation.join();
+    simulationThreaded = false;
+    audio.setDeferred(false);
+    audio.update();
+    framePacer.setTimerOnly(false);
+}
+
+void Game::simulationLoop() {
+    while (!quitRequested) {
+        bool simulating = isSimulating();
+        if (!simulating && !needsRedraw && gameState == renderedState) {
+            std::unique_lock<std::mutex> lock(eventMutex);
+            eventReady.wait_for(lock, std::chrono::milliseconds(idleTimeout()),
+                                [this] { return !pendingEvents.empty() || quitRequested; });
+        }
+        {
+            PROFILE_ZONE("Game::simulationLoop");
+            handleQueuedEvents();
+            if (quitRequested) break;
+            simulating = advanceFrame();
+            if (isFrameDue(simulating)) {
+                buildRenderList(renderBuffer.back());
+                renderBuffer.publish();
+                wakeRenderer();
+                needsRedraw = false;
+                renderedState = gameState;
+            }
+        }
+        PROFILE_FRAME(simulating);
+        ALLOC_FRAME();
+        if (simulating) framePacer.endFrame();
+        else framePacer.reset();
+    }
+    wakeRenderer();
+}
+
+bool Game::isSimulating() const {
+    return (gameState == PLAYING && !paused) || net.isActive();
+}
+
+bool Game::isFrameDue(bool simulating) const {
+    return !isMinimized && (simulating || needsRedraw || gameState != renderedState);
+}
+
+int Game::idleTimeout() const {
+    return (hasFocus && !isMinimized) ? MENU_IDLE_TIMEOUT_MS : BACKGROUND_IDLE_TIMEOUT_MS;
+}
+
+bool Game::advanceFrame() {
+    bool simulating = isSimulating();
+    if (simulating) simulateTick();
+    if (replayMode != REPLAY_OFF && (gameState != PLAYING || !replay.hasInput())) finishReplay();
+    updateMusic();
+    return simulating;
+}
+
+void Game::requestQuit(int code) {
+    exitCode = code;
+    quitRequested = true;
+}
+
+void Game::wakeRenderer() {
+    SDL_Event wake = {};
+    wake.type = wakeEventType;
+    SDL_PushEvent(&wake);
+}
+
+void Game::forwardEvents() {
+    PROFILE_ZONE("Game::forwardEvents");
     SDL_Event e;
+    bool received = false;
     while (SDL_PollEvent(&e)) {
-        if (e.type == SDL_QUIT) { close(); exit(0); }
-        if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT) {
-            int x = e.button.x, y = e.button.y;
-            if (gameState == MAIN_MENU) {
-                if (checkCollision({x, y, 1, 1}, menuButtons[0].rect)) {
-                    resetGame();
-                    gameState = PLAYING;
-                    if (musicOn) { Mix_HaltMusic(); Mix_PlayMusic(inGameMusic, -1); }
-                } else if (checkCollision({x, y, 1, 1}, menuButtons[1].rect)) gameState = INSTRUCTIONS;
-                else if (checkCollision({x, y, 1, 1}, menuButtons[2].rect)) gameState = RECORDS;
-                else if (checkCollision({x, y, 1, 1}, menuButtons[3].rect)) gameState = OPTIONS;
-            } else if (gameState == INSTRUCTIONS || gameState == RECORDS) {
-                if (checkCollision({x, y, 1, 1}, menuButtons[0].rect)) gameState = MAIN_MENU;
-            } else if (gameState == OPTIONS) {
-                if (checkCollision({x, y, 1, 1}, menuButtons[0].rect)) {
-                    musicOn = !musicOn;
-                    if (!musicOn) Mix_HaltMusic(); else Mix_PlayMusic(menuMusic, -1);
-                } else if (checkCollision({x, y, 1, 1}, menuButtons[1].rect)) sfxOn = !sfxOn;
-                else if (checkCollision({x, y, 1, 1}, menuButtons[2].rect)) gameState = MAIN_MENU;
-            } else if (gameState == GAME_OVER) {
-                if (checkCollision({x, y, 1, 1}, menuButtons[0].rect)) {
-                    resetGame();
-                    gameState = PLAYING;
-                    if (musicOn) Mix_PlayMusic(inGameMusic, -1);
-                } else if (checkCollision({x, y, 1, 1}, menuButtons[1].rect)) gameState = MAIN_MENU;
-                else if (checkCollision({x, y, 1, 1}, menuButtons[2].rect)) { close(); exit(0); }
+        if (e.type == wakeEventType) continue;
+        if (e.type == SDL_QUIT) requestQuit(0);
+        std::lock_guard<std::mutex> lock(eventMutex);
+        pendingEvents.push_back(e);
+        received = true;
+    }
+    heldInput = readKeyboard();
+    if (received || quitRequested) eventReady.notify_one();
+}
+
+void Game::handleQueuedEvents() {
+    {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        queuedEvents.swap(pendingEvents);
+    }
+    for (const auto& e : queuedEvents) {
+        handleEvent(e);
+        if (quitRequested) break;
+    }
+    queuedEvents.clear();
+}
+
+void Game::handleEvents() {
+    PROFILE_ZONE("Game::handleEvents");
+    SDL_Event e;
+    while (!quitRequested && SDL_PollEvent(&e)) handleEvent(e);
+    heldInput = readKeyboard();
+}
+
+void Game::handleEvent(const SDL_Event& e) {
+    if (e.type == SDL_QUIT) { requestQuit(0); return; }
+    if (e.type == SDL_WINDOWEVENT) handleWindowEvent(e.window);
+    if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT) {
+        needsRedraw = true;
+        int x = e.button.x, y = e.button.y;
+        // Several queued clicks can land before the next render list, so hit-test
+        // against the buttons of the current state rather than the last frame's.
+        layoutMenuButtons();
+        if (gameState == MAIN_MENU) {
+            if (isButtonHit(0, x, y) && !net.isActive()) {
+                resetGame();
+                gameState = PLAYING;
+                if (musicOn) audio.playMusic(inGameMusic.get());
+            } else if (isButtonHit(1, x, y)) gameState = INSTRUCTIONS;
+            else if (isButtonHit(2, x, y)) gameState = RECORDS;
+            else if (isButtonHit(3, x, y)) gameState = OPTIONS;
+        } else if (gameState == INSTRUCTIONS || gameState == RECORDS) {
+            if (isButtonHit(0, x, y)) gameState = MAIN_MENU;
+        } else if (gameState == OPTIONS) {
+            if (isButtonHit(0, x, y)) {
+                musicOn = !musicOn;
+                if (!musicOn) audio.haltMusic(); else audio.playMusic(menuMusic.get());
+            } else if (isButtonHit(1, x, y)) sfxOn = !sfxOn;
+            else if (isButtonHit(2, x, y)) {
+                audio.setLowLatency(!audio.isLowLatency());
             }
+            else if (isButtonHit(3, x, y)) {
+                renderScale = static_cast<RenderScaleMode>((renderScale + 1) % 3);
+            }
+            else if (isButtonHit(4, x, y)) gameState = MAIN_MENU;
+        } else if (gameState == GAME_OVER) {
+            if (isButtonHit(0, x, y) && !net.isActive()) {
+                resetGame();
+                gameState = PLAYING;
+                if (musicOn) audio.playMusic(inGameMusic.get());
+            } else if (isButtonHit(1, x, y)) gameState = MAIN_MENU;
+            else if (isButtonHit(2, x, y)) { requestQuit(0); return; }
         }
-        if (gameState == PLAYING && e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_SPACE && shootCooldown <= 0 && !isSpacePressed) {
-            fireBullet();
-            shootCooldown = 13;
-            isSpacePressed = true;
+    }
+    if (gameState == PLAYING && e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_SPACE) spaceTapped = true;
+    if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F9) PROFILE_CAPTURE(PROFILE_CAPTURE_FRAMES);
+    if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F3) {
+        showSightLines = !showSightLines;
+        needsRedraw = true;
+    }
+    if (replayMode == REPLAY_OFF && e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F5 && gameState == PLAYING) {
+        snapshot(checkpoint);
+        hasCheckpoint = true;
+    }
+    if (replayMode == REPLAY_OFF && !net.isActive() && e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F8 && hasCheckpoint &&
+        (gameState == PLAYING || gameState == GAME_OVER)) {
+        if (gameState == GAME_OVER && musicOn) audio.playMusic(inGameMusic.get());
+        restore(checkpoint);
+        particles.reset(runSeed + simulationTick);
+        replay.truncate(simulationTick);
+        needsRedraw = true;
+    }
+    if (replayMode == REPLAY_REALTIME && e.type == SDL_KEYDOWN) {
+        if (e.key.keysym.sym == SDLK_LEFT) seekReplay(simulationTick - REPLAY_SEEK_STEP);
+        else if (e.key.keysym.sym == SDLK_RIGHT) seekReplay(simulationTick + REPLAY_SEEK_STEP);
+    }
+}
+
+Uint8 Game::readKeyboard() {
+    const Uint8* keystate = SDL_GetKeyboardState(NULL);
+    Uint8 input = 0;
+    if (keystate[SDL_SCANCODE_A]) input |= INPUT_LEFT;
+    if (keystate[SDL_SCANCODE_D]) input |= INPUT_RIGHT;
+    if (keystate[SDL_SCANCODE_W]) input |= INPUT_JUMP;
+    if (keystate[SDL_SCANCODE_SPACE]) input |= INPUT_FIRE;
+    return input;
+}
+
+Uint8 Game::pollInput() {
+    Uint8 input = heldInput;
+    if (spaceTapped) input |= INPUT_FIRE;
+    spaceTapped = false;
+    return input;
+}
+
+void Game::applyInput(Uint8 input) {
+    playerVelX = 0;
+    if (input & INPUT_LEFT) { playerVelX -= PLAYER_SPEED; playerFlipped = true; }
+    if (input & INPUT_RIGHT) { playerVelX += PLAYER_SPEED; playerFlipped = false; }
+    if ((input & INPUT_JUMP) && isOnGround && !isJumping) {
+        isJumping = true; isOnGround = false; playerVelY = JUMP_FORCE; playSFX(jumpSound.get());
+    }
+    if (!(input & INPUT_FIRE)) {
+        isSpacePressed = false;
+    } else if (shootCooldown <= 0 && !isSpacePressed) {
+        fireBullet();
+        shootCooldown = 13;
+        isSpacePressed = true;
+    }
+}
+
+void Game::simulateTick() {
+    if (net.isActive()) {
+        simulateNetTick();
+        return;
+    }
+    Uint8 input;
+    if (replayMode == REPLAY_OFF) {
+        input = pollInput();
+        replay.recordInput(input);
+    } else {
+        input = replay.nextInput();
+    }
+    applyInput(input);
+    update();
+
+    if (simulationTick % REPLAY_CHECKSUM_INTERVAL == 0) {
+        Uint32 checksum = stateChecksum();
+        if (replayMode == REPLAY_OFF) {
+            replay.recordChecksum(checksum);
+        } else if (replayDesyncTick < 0 && !replay.checkChecksum(simulationTick, checksum)) {
+            replayDesyncTick = simulationTick;
+            printf("Replay desync at tick %d\n", simulationTick);
         }
+    }
+    if (replayMode != REPLAY_OFF && simulationTick % REPLAY_KEYFRAME_INTERVAL == 0 &&
+        (keyframes.empty() || keyframes.back().core.tick < simulationTick)) {
+        keyframes.emplace_back();
+        snapshot(keyframes.back());
+    }
+}
 
-        if (gameState == PLAYING && e.type == SDL_KEYUP && e.key.keysym.sym == SDLK_SPACE) {
-            isSpacePressed = false;
+bool Game::startNetPlay(const char* hostName, Uint16 port, int delayMs, int jitterMs, int lossPercent) {
+    if (!(hostName ? net.join(hostName, port) : net.host(port))) return false;
+    net.setConditions(delayMs, jitterMs, lossPercent);
+    return true;
+}
+
+void Game::simulateNetTick() {
+    net.poll();
+    if (!net.isActive()) {
+        if (gameState == PLAYING) gameState = GAME_OVER;
+        return;
+    }
+    if (net.takeConnected()) {
+        netStates.resize(NET_ROLLBACK_WINDOW);
+        resetGame(net.getSeed());
+        gameState = PLAYING;
+        if (musicOn) audio.playMusic(inGameMusic.get());
+    }
+    if (!net.isConnected()) {
+        net.sendInputs();
+        return;
+    }
+
+    int rollbackFrame = net.takeRollbackFrame();
+    if (rollbackFrame >= 0 && rollbackFrame < simulationTick) {
+        int targetTick = net.getLocalFrames();
+        restore(netStates[rollbackFrame % NET_ROLLBACK_WINDOW]);
+        seeking = true;
+        while (simulationTick < targetTick && gameState == PLAYING) advanceNetFrame();
+        seeking = false;
+    }
+
+    if (gameState == PLAYING && net.canAdvance(simulationTick)) {
+        net.addLocalInput(pollInput());
+        advanceNetFrame();
+    }
+    net.sendInputs();
+    if (gameState == GAME_OVER && net.isSettled(simulationTick)) net.finish();
+}
+
+void Game::advanceNetFrame() {
+    int frame = simulationTick;
+    snapshot(netStates[frame % NET_ROLLBACK_WINDOW]);
+    applyInput(net.getInput(frame));
+    update();
+    if (net.isConfirmed(frame) && simulationTick % REPLAY_CHECKSUM_INTERVAL == 0) net.recordChecksum(simulationTick, stateChecksum());
+}
+
+bool Game::startReplay(const char* path, ReplayMode mode, int seekTick) {
+    if (!replay.load(path)) return false;
+    replayMode = mode;
+    replayDesyncTick = -1;
+    keyframes.clear();
+    resetGame(replay.getSeed());
+    gameState = PLAYING;
+    if (musicOn && mode == REPLAY_REALTIME) audio.playMusic(inGameMusic.get());
+    if (seekTick > 0) seekReplay(seekTick);
+    return true;
+}
+
+int Game::runRenderBenchmark(const char* replayPath, const char* goldenDir, bool updateGolden) {
+    if (replayPath) {
+        if (!replay.load(replayPath)) return 1;
+    } else {
+        replay.beginRecording(RENDER_BENCH_SEED);
+        for (int tick = 0; tick < RENDER_BENCH_SCRIPT_TICKS; tick++) replay.recordInput(RenderBench::scriptedInput(tick));
+    }
+    replayMode = REPLAY_FAST;
+    replayDesyncTick = -1;
+    renderScale = RENDER_SCALE_NATIVE;
+    resetGame(replay.getSeed());
+    gameState = PLAYING;
+    seeking = true;
+
+    RenderBench bench(goldenDir, updateGolden);
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    while (gameState == PLAYING && replay.hasInput()) {
+        // The blind script cannot dodge, so keep its lives topped up: hits and falls still
+        // play out on screen but never end the run before every golden checkpoint is drawn.
+        if (!replayPath) lives = 3;
+        simulateTick();
+        drawCalls = 0;
+        Uint64 start = SDL_GetPerformanceCounter();
+        render();
+        bench.recordFrame(simulationTick, static_cast<double>(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency, drawCalls);
+        ALLOC_FRAME();
+        if (simulationTick % RENDER_GOLDEN_INTERVAL == 0) bench.checkGolden(simulationTick, frameSurface);
+    }
+    seeking = false;
+    replayMode = REPLAY_OFF;
+    if (replayDesyncTick >= 0) printf("Replay desynced at tick %d, frames after it are not comparable\n", replayDesyncTick);
+    bool allocationFree = ALLOC_REPORT();
+    return bench.report() && allocationFree ? 0 : 1;
+}
+
+int Game::runPerfBenchmark(const char* replayPath, bool renderFrames, const char* baselinePath, bool updateBaseline) {
+    PerfBench bench(baselinePath, updateBaseline);
+    replayMode = REPLAY_FAST;
+    renderScale = RENDER_SCALE_NATIVE;
+    seeking = true;
+
+    int sessionCount;
+    const PerfSession* sessions = PerfBench::sessions(sessionCount);
+    for (int i = 0; i < sessionCount; i++) {
+        const PerfSession& session = sessions[i];
+        bench.beginSession(session.name, session.ticks);
+        Uint32 seed = session.seed;
+        for (int tick = 0; tick < session.ticks; tick++) {
+            bench.beginTick();
+            if (tick == 0 || gameState != PLAYING || (session.resetInterval > 0 && tick % session.resetInterval == 0)) {
+                resetGame(seed++);
+                gameState = PLAYING;
+            }
+            applyInput(session.input(tick));
+            update();
+            if (renderFrames) render();
+            bench.endTick();
+            ALLOC_FRAME();
         }
+        bench.endSession();
     }
 
-    if (gameState == PLAYING) {
-        const Uint8* keystate = SDL_GetKeyboardState(NULL);
-        playerVelX = 0.0f;
-        if (keystate[SDL_SCANCODE_A]) { playerVelX -= PLAYER_SPEED; playerFlipped = true; }
-        if (keystate[SDL_SCANCODE_D]) { playerVelX += PLAYER_SPEED; playerFlipped = false; }
-        if (keystate[SDL_SCANCODE_W] && isOnGround && !isJumping) {
-            isJumping = true; isOnGround = false; playerVelY = JUMP_FORCE; playSFX(jumpSound);
+    if (replayPath && replay.load(replayPath)) {
+        bench.beginSession("replay", replay.getTickCount());
+        resetGame(replay.getSeed());
+        gameState = PLAYING;
+        while (gameState == PLAYING && replay.hasInput()) {
+            bench.beginTick();
+            applyInput(replay.nextInput());
+            update();
+            if (renderFrames) render();
+            bench.endTick();
+            ALLOC_FRAME();
         }
+        bench.endSession();
+    }
+
+    seeking = false;
+    replayMode = REPLAY_OFF;
+    bool allocationFree = ALLOC_REPORT();
+    return bench.report() && allocationFree ? 0 : 1;
+}
+
+int Game::runReachabilityBatch(Uint32 firstSeed, int seedCount, int chunksPerSeed) {
+    int workerCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<ReachabilityStats> totals(workerCount, ReachabilityStats());
+    std::vector<std::vector<Uint32>> failedSeeds(workerCount);
+    std::vector<std::thread> workers;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int worker = 0; worker < workerCount; worker++) {
+        workers.emplace_back([&, worker]() {
+            Game game(true);
+            for (int i = worker; i < seedCount; i += workerCount) {
+                Uint32 seed = firstSeed + i;
+                long long failedBefore = game.reachStats.failed;
+                game.resetGame(seed);
+                for (int chunk = 0; chunk < chunksPerSeed; chunk++) {
+                    game.cameraX = std::max(game.cameraX, game.lastGeneratedX - SCREEN_WIDTH * 2);
+                    game.cleanUpObjects();
+                    game.generateWorld();
+                }
+                if (game.reachStats.failed > failedBefore && failedSeeds[worker].size() < REACH_BATCH_REPORTED_SEEDS) {
+                    failedSeeds[worker].push_back(seed);
+                }
+            }
+            totals[worker] = game.reachStats;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    ReachabilityStats total = {0, 0, 0};
+    for (const auto& stats : totals) {
+        total.chunks += stats.chunks;
+        total.patched += stats.patched;
+        total.failed += stats.failed;
+    }
+    double seconds = static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    printf("Validated %lld chunks from %d seeds in %.1f s (%.2f us per chunk, %d threads)\n", total.chunks, seedCount,
+           seconds, total.chunks ? seconds * 1000000.0 * workerCount / total.chunks : 0.0, workerCount);
+    printf("Patched %lld chunks, %lld left unreachable\n", total.patched, total.failed);
+    for (const auto& seeds : failedSeeds) {
+        for (Uint32 seed : seeds) printf("Unreachable chunk in seed %u\n", seed);
+    }
+    return total.failed == 0 ? 0 : 1;
+}
+
+void Game::reset(Uint32 seed) {
+    resetGame(seed);
+    gameState = PLAYING;
+}
+
+void Game::step(Uint8 input) {
+    if (gameState != PLAYING) return;
+    applyInput(input);
+    update();
+}
+
+void Game::observe(EnvObservation& observation) const {
+    observation.playerX = playerRect.x - cameraX;
+    observation.playerY = playerRect.y;
+    observation.velocityX = playerVelX;
+    observation.velocityY = playerVelY;
+    observation.lives = lives;
+
+    int centerX = playerRect.x + playerRect.w / 2;
+    int centerY = playerRect.y + playerRect.h / 2;
+    int enemyDistance = SCREEN_WIDTH;
+    observation.enemyDX = SCREEN_WIDTH;
+    observation.enemyDY = 0;
+    std::vector<Tile> solids;
+    forEachEnemyType([&](auto type) {
+        constexpr int Type = decltype(type)::value;
+        for (const auto& tracked : enemies[Type]) {
+            int reach = tracked.pendingTicks * (fixedToInt(EnemyTraits<Type>::speed) + 1);
+            if (!tracked.active || std::abs(tracked.rect.x + tracked.rect.w / 2 - centerX) >= enemyDistance + reach) continue;
+            Enemy enemy = tracked;
+            if (enemy.pendingTicks > 0) {
+                this->template gatherEnemyTiles<Type>(enemy, solids);
+                this->template advanceRemoteEnemy<Type>(enemy, solids);
+            }
+            int dx = enemy.rect.x + enemy.rect.w / 2 - centerX;
+            if (!enemy.active || std::abs(dx) >= enemyDistance) continue;
+            enemyDistance = std::abs(dx);
+            observation.enemyDX = dx;
+            observation.enemyDY = enemy.rect.y + enemy.rect.h / 2 - centerY;
+        }
+    });
+    int bulletDistance = SCREEN_WIDTH;
+    observation.bulletDX = SCREEN_WIDTH;
+    observation.bulletDY = 0;
+    for (const auto& bullet : projectiles.getProjectiles()) {
+        int dx = bullet.rect.x - centerX;
+        if (!bullet.active || bullet.team != TEAM_ENEMY || std::abs(dx) >= bulletDistance) continue;
+        bulletDistance = std::abs(dx);
+        observation.bulletDX = dx;
+        observation.bulletDY = bullet.rect.y - centerY;
+    }
+
+    observation.groundAhead = 0;
+    int surfaceY;
+    for (int column = 0; column < ENV_GROUND_COLUMNS; column++) {
+        int left = playerRect.x + column * TILE_SIZE;
+        if (terrain->findSurface(left, left + TILE_SIZE - 1, playerRect.y, SCREEN_HEIGHT, surfaceY)) {
+            observation.groundAhead |= 1u << column;
+        }
+    }
+}
+
+void Game::seekReplay(int targetTick) {
+    targetTick = std::max(0, std::min(targetTick, replay.getTickCount()));
+    if (targetTick < simulationTick || gameState != PLAYING) {
+        const GameSnapshot* nearest = nullptr;
+        for (const auto& keyframe : keyframes) {
+            if (keyframe.core.tick <= targetTick) nearest = &keyframe;
+        }
+        if (nearest) restore(*nearest);
+        else resetGame(replay.getSeed());
+        particles.reset(runSeed + simulationTick);
+        gameState = PLAYING;
+        replay.rewind(simulationTick);
+    }
+    fastForwardReplay(targetTick);
+    needsRedraw = true;
+}
+
+void Game::fastForwardReplay(int targetTick) {
+    seeking = true;
+    while (gameState == PLAYING && simulationTick < targetTick && replay.hasInput()) {
+        simulateTick();
+        if (simulationTick % 1000 == 0 && !simulationThreaded) SDL_PumpEvents();
+    }
+    seeking = false;
+}
+
+void Game::finishReplay() {
+    printf("Replay finished at tick %d/%d: score %d, lives %d, %s\n", simulationTick, replay.getTickCount(),
+           score, lives, replayDesyncTick < 0 ? "in sync" : "desynced");
+    ReplayMode mode = replayMode;
+    replayMode = REPLAY_OFF;
+    keyframes.clear();
+    if (mode == REPLAY_FAST) {
+        requestQuit(replayDesyncTick < 0 ? 0 : 2);
+        return;
+    }
+    gameState = GAME_OVER;
+}
+
+void Game::snapshot(GameSnapshot& state) const {
+    SnapshotCore& core = state.core;
+    core.tick = simulationTick;
+    core.runSeed = runSeed;
+    core.isJumping = isJumping;
+    core.isOnGround = isOnGround;
+    core.isSpacePressed = isSpacePressed;
+    core.playerFlipped = playerFlipped;
+    core.isInvincible = isInvincible;
+    core.runOver = gameState != PLAYING;
+    core.playerPosX = playerPosX;
+    core.playerPosY = playerPosY;
+    core.playerVelX = playerVelX;
+    core.playerVelY = playerVelY;
+    core.score = score;
+    core.cameraX = cameraX;
+    core.maxPlayerX = maxPlayerX;
+    core.shootCooldown = shootCooldown;
+    core.groundHeight = groundHeight;
+    core.lastGeneratedX = lastGeneratedX;
+    core.lives = lives;
+    core.invincibilityTimer = invincibilityTimer;
+    core.lastDifficultyThreshold = lastDifficultyThreshold;
+    core.currentSpawnThreshold = currentSpawnThreshold;
+    core.playerRect = playerRect;
+    state.tiles = tiles;
+    state.terrain = terrain;
+    state.navGraph = navGraph;
+    state.projectiles = projectiles.getProjectiles();
+    state.enemies = enemies;
+    state.spikes = spikes;
+    state.gen = gen;
+}
+
+void Game::restore(const GameSnapshot& state) {
+    const SnapshotCore& core = state.core;
+    simulationTick = core.tick;
+    runSeed = core.runSeed;
+    isJumping = core.isJumping;
+    isOnGround = core.isOnGround;
+    isSpacePressed = core.isSpacePressed;
+    playerFlipped = core.playerFlipped;
+    isInvincible = core.isInvincible;
+    playerPosX = core.playerPosX;
+    playerPosY = core.playerPosY;
+    playerVelX = core.playerVelX;
+    playerVelY = core.playerVelY;
+    score = core.score;
+    cameraX = core.cameraX;
+    maxPlayerX = core.maxPlayerX;
+    shootCooldown = core.shootCooldown;
+    groundHeight = core.groundHeight;
+    lastGeneratedX = core.lastGeneratedX;
+    lives = core.lives;
+    invincibilityTimer = core.invincibilityTimer;
+    lastDifficultyThreshold = core.lastDifficultyThreshold;
+    currentSpawnThreshold = core.currentSpawnThreshold;
+    playerRect = core.playerRect;
+    tiles = state.tiles;
+    terrain = state.terrain;
+    navGraph = state.navGraph;
+    navField.invalidate();
+    projectiles.restore(state.projectiles);
+    enemies = state.enemies;
+    spikes = state.spikes;
+    gen = state.gen;
+    gameState = core.runOver ? GAME_OVER : PLAYING;
+}
+
+Uint32 Game::stateChecksum() const {
+    Fixed player[3] = {playerPosX, playerPosY, playerVelY};
+    Uint32 hash = hashBytes(player, sizeof(player));
+    hash = hashBytes(&cameraX, sizeof(cameraX), hash);
+    int counters[6] = {score, lives, shootCooldown, static_cast<int>(tiles->size()),
+                       projectiles.count(TEAM_PLAYER), projectiles.count(TEAM_ENEMY)};
+    hash = hashBytes(counters, sizeof(counters), hash);
+    for (const auto& bucket : enemies) {
+        for (const auto& enemy : bucket) {
+            Fixed position[2] = {enemy.positionX, enemy.positionY};
+            hash = hashBytes(position, sizeof(position), hash);
+        }
+    }
+    return hash;
+}
+
+int Game::randomInt(int n) {
+    return static_cast<int>(gen() % static_cast<Uint32>(n));
+}
+
+bool Game::chance(int perMille) {
+    return randomInt(1000) < perMille;
+}
+
+void Game::handleWindowEvent(const SDL_WindowEvent& event) {
+    switch (event.event) {
+        case SDL_WINDOWEVENT_FOCUS_LOST: hasFocus = false; setPaused(true); break;
+        case SDL_WINDOWEVENT_MINIMIZED: isMinimized = true; setPaused(true); break;
+        case SDL_WINDOWEVENT_FOCUS_GAINED: hasFocus = true; if (!isMinimized) setPaused(false); break;
+        case SDL_WINDOWEVENT_RESTORED: isMinimized = false; if (hasFocus) setPaused(false); break;
+    }
+    needsRedraw = true;
+}
+
+void Game::setPaused(bool pause) {
+    if (pause == paused || (pause && (gameState != PLAYING || net.isActive()))) return;
+    paused = pause;
+    if (paused) {
+        if (musicOn) audio.pauseMusic();
+    } else {
+        if (musicOn) audio.resumeMusic();
     }
 }
 
 void Game::update() {
+    PROFILE_ZONE("Game::update");
+    PERF_SCOPE(PERF_UPDATE);
+    ALLOC_PHASE(ALLOC_PHASE_UPDATE);
+    simulationTick++;
     if (shootCooldown > 0) shootCooldown--;
+    particles.update();
 
     playerVelY += GRAVITY;
     SDL_Rect futureRect = playerRect;
-    futureRect.x += playerVelX;
-    futureRect.y += playerVelY;
+    futureRect.x = fixedToInt(playerPosX + playerVelX);
+    futureRect.y = fixedToInt(playerPosY + playerVelY);
 
     cameraX += CAMERA_SPEED;
 
-    static float spawnThreshold = 0.9f;
-    static float enemyBulletSpeed = 3.0f;
-    static int lastThreshold = 0;
-    int nextThreshold = getNextDifficultyThreshold(lastThreshold);
+    int nextThreshold = getNextDifficultyThreshold(lastDifficultyThreshold);
     if (score >= nextThreshold && score >= 100) {
-        spawnThreshold = 0.9f - 0.03f * (score / 100);
-        spawnThreshold = std::max(0.3f, spawnThreshold);
-        enemyBulletSpeed += 0.1f;
-        lastThreshold = nextThreshold;
+        currentSpawnThreshold = baseSpawnThreshold - spawnThresholdDecrease * (score / 100);
+        currentSpawnThreshold = std::max(300, currentSpawnThreshold);
+        lastDifficultyThreshold = nextThreshold;
     }
 
     isOnGround = false;
     bool horizontalCollision = false;
 
-    for (const auto& tile : tiles) {
+    for (const auto& tile : *tiles) {
         if (checkCollision(futureRect, tile.rect)) {
             if (playerVelY > 0 && playerRect.y + playerRect.h <= tile.rect.y) {
-                playerRect.y = tile.rect.y - playerRect.h;
+                playerPosY = toFixed(tile.rect.y - playerRect.h);
                 playerVelY = 0;
                 isOnGround = true;
                 isJumping = false;
             } else if (playerVelY < 0 && playerRect.y >= tile.rect.y + tile.rect.h) {
-                playerRect.y = tile.rect.y + tile.rect.h;
+                playerPosY = toFixed(tile.rect.y + tile.rect.h);
                 playerVelY = 0;
             } else if (playerVelX != 0 && playerRect.y + playerRect.h > tile.rect.y && playerRect.y < tile.rect.y + tile.rect.h) {
                 if (playerVelX > 0 && playerRect.x + playerRect.w <= tile.rect.x) {
-                    playerRect.x = tile.rect.x - playerRect.w;
+                    playerPosX = toFixed(tile.rect.x - playerRect.w);
                     horizontalCollision = true;
-                    if (isJumping && playerVelY < 0) playerRect.y += playerVelY;
+                    if (isJumping && playerVelY < 0) playerPosY += playerVelY;
                 } else if (playerVelX < 0 && playerRect.x >= tile.rect.x + tile.rect.w) {
-                    playerRect.x = tile.rect.x + tile.rect.w;
+                    playerPosX = toFixed(tile.rect.x + tile.rect.w);
                     horizontalCollision = true;
-                    if (isJumping && playerVelY < 0) playerRect.y += playerVelY;
+                    if (isJumping && playerVelY < 0) playerPosY += playerVelY;
                 }
             }
+            syncPlayerRect();
         }
     }
 
-    if (!horizontalCollision) playerRect.x += playerVelX;
-    if (!isOnGround && (!horizontalCollision || (horizontalCollision && playerVelY >= 0))) playerRect.y += playerVelY;
+    if (!horizontalCollision) playerPosX += playerVelX;
+    if (!isOnGround && (!horizontalCollision || (horizontalCollision && playerVelY >= 0))) playerPosY += playerVelY;
 
-    if (playerRect.x < cameraX + TILE_SIZE) playerRect.x = cameraX + TILE_SIZE;
+    if (fixedToInt(playerPosX) < cameraX + TILE_SIZE) playerPosX = toFixed(cameraX + TILE_SIZE);
+    syncPlayerRect();
     if (playerRect.x > maxPlayerX) {
         maxPlayerX = playerRect.x;
-        score = static_cast<int>(maxPlayerX / 10);
+        score = maxPlayerX / 10;
     }
 
-    for (auto& bullet : bullets) {
-        if (bullet.active) {
-            bullet.rect.x += bullet.facingLeft ? -bullet.speed : bullet.speed;
-            bullet.distanceTraveled = std::abs(bullet.rect.x - bullet.startX);
-            if (bullet.distanceTraveled > BULLET_MAX_DISTANCE) bullet.active = false;
-            for (const auto& tile : tiles) {
-                if (checkCollision(bullet.rect, tile.rect)) { bullet.active = false; break; }
-            }
-            if (bullet.rect.x < cameraX || bullet.rect.x > cameraX + SCREEN_WIDTH) bullet.active = false;
-        }
-    }
+    projectiles.update(TEAM_PLAYER, *tiles, cameraX);
 
     updateEnemies();
 
     for (auto& spike : spikes) {
-        spike.x = (int)cameraX;
+        spike.x = cameraX;
         if (!isInvincible &&
             playerRect.x <= spike.x + spike.w &&
             playerRect.x + playerRect.w > spike.x &&
             playerRect.y + playerRect.h > spike.y &&
             playerRect.y < spike.y + spike.h) {
             lives--;
-            playSFX(hitSound);
-            heartTextures[lives] = heartTextures[3];
-            invincibilityTimer = SDL_GetTicks() + 2000;
+            playSFX(hitSound.get());
+            invincibilityTimer = simulationTick + INVINCIBILITY_TICKS;
             isInvincible = true;
             if (lives <= 0) {
-                if (score > bestScore) { bestScore = score; saveBestScore(); }
-                gameState = GAME_OVER;
+                endRun(DEATH_SPIKES);
             }
             break;
         }
@@ -285,193 +890,269 @@ void Game::update() {
     if (playerRect.y > SCREEN_HEIGHT) {
         if (lives > 0) {
             lives--;
-            playSFX(hitSound);
-            heartTextures[lives] = heartTextures[3];
-            playerRect.y = SCREEN_HEIGHT - PLAYER_HEIGHT;
+            playSFX(hitSound.get());
+            playerPosY = toFixed(SCREEN_HEIGHT - PLAYER_HEIGHT);
             playerVelY = JUMP_FORCE;
-            invincibilityTimer = SDL_GetTicks() + 2000;
+            syncPlayerRect();
+            invincibilityTimer = simulationTick + INVINCIBILITY_TICKS;
             isInvincible = true;
         } else {
-            if (score > bestScore) { bestScore = score; saveBestScore(); }
-            gameState = GAME_OVER;
+            endRun(DEATH_FALL);
         }
     }
 
-    if (isInvincible && SDL_GetTicks() > invincibilityTimer) isInvincible = false;
+    if (isInvincible && simulationTick > invincibilityTimer) isInvincible = false;
 
     cleanUpObjects();
-    if (tiles.empty() || tiles.back().rect.x + tiles.back().rect.w < cameraX + SCREEN_WIDTH + TILE_SIZE * 10) generateWorld();
+    if (tiles->empty() || tiles->back().rect.x + tiles->back().rect.w < cameraX + SCREEN_WIDTH + TILE_SIZE * 10) generateWorld();
 }
 
 void Game::render() {
-    SDL_RenderClear(renderer);
+    PERF_SCOPE(PERF_RENDER);
+    buildRenderList(renderBuffer.back());
+    renderBuffer.publish();
+    submitRenderList(*renderBuffer.acquire());
+}
+
+bool Game::isButtonHit(size_t index, int x, int y) const {
+    return index < menuButtons.size() && checkCollision({x, y, 1, 1}, menuButtons[index].rect);
+}
+
+void Game::layoutMenuButtons() {
+    const char* renderScaleNames[] = {"FULL", "AUTO", "LOW"};
+    if (gameState == MAIN_MENU) {
+        menuButtons = {{{SCREEN_WIDTH / 2 - 25, 250, 100, 50}, "Play"},
+                       {{SCREEN_WIDTH / 2 - 25, 320, 100, 50}, "Instructions"},
+                       {{SCREEN_WIDTH / 2 - 25, 460, 100, 50}, "Records"},
+                       {{SCREEN_WIDTH / 2 - 25, 390, 100, 50}, "Options"}};
+    } else if (gameState == INSTRUCTIONS) {
+        menuButtons = {{{SCREEN_WIDTH / 2 - 25, 450, 100, 50}, "Back"}};
+    } else if (gameState == RECORDS) {
+        menuButtons = {{{SCREEN_WIDTH / 2 - 30, 440, 100, 50}, "Back"}};
+    } else if (gameState == OPTIONS) {
+        menuButtons = {{{SCREEN_WIDTH / 2 + 50, 200, 50, 50}, musicOn ? "ON" : "OFF"},
+                       {{SCREEN_WIDTH / 2 + 50, 270, 50, 50}, sfxOn ? "ON" : "OFF"},
+                       {{SCREEN_WIDTH / 2 + 50, 340, 50, 50}, audio.isLowLatency() ? "LOW" : "STD"},
+                       {{SCREEN_WIDTH / 2 + 50, 410, 50, 50}, renderScaleNames[renderScale]},
+                       {{SCREEN_WIDTH / 2 - 25, 480, 100, 50}, "Back"}};
+    } else if (gameState == GAME_OVER) {
+        menuButtons = {{{SCREEN_WIDTH / 2 - 25, 270, 100, 50}, "Play Again"},
+                       {{SCREEN_WIDTH / 2 - 25, 340, 100, 50}, "Main Menu"},
+                       {{SCREEN_WIDTH / 2 - 25, 410, 100, 50}, "Exit"}};
+    } else {
+        menuButtons.clear();
+    }
+}
+
+void Game::buildRenderList(RenderList& list) {
+    PROFILE_ZONE("Game::buildRenderList");
+    ALLOC_PHASE(ALLOC_PHASE_RENDER);
+    frameArena.reset();
+    list.clear();
+    list.scaleMode = renderScale;
+    list.simulating = isSimulating();
+    if (gameState == PLAYING) list.command(RENDER_BEGIN_WORLD);
 
     for (int y = 0; y < SCREEN_HEIGHT; y += TILE_SIZE) {
-        for (int x = 0; x < SCREEN_WIDTH + (int)cameraX; x += TILE_SIZE) {
-            SDL_Rect dest = {x - (int)cameraX, y, TILE_SIZE, TILE_SIZE};
-            SDL_RenderCopy(renderer, backgroundTexture, NULL, &dest);
+        for (int x = cameraX - cameraX % TILE_SIZE; x < SCREEN_WIDTH + cameraX; x += TILE_SIZE) {
+            list.sprite(SPRITE_BACKGROUND, {x - cameraX, y, TILE_SIZE, TILE_SIZE});
         }
     }
 
     SDL_Color white = {255, 255, 255, 255};
     SDL_Color yellow = {255, 255, 0, 255};
     SDL_Color black = {87, 22, 112, 255};
+    const char* renderScaleNames[] = {"FULL", "AUTO", "LOW"};
+    layoutMenuButtons();
 
     if (gameState == MAIN_MENU) {
-        renderText("Umbraked", SCREEN_WIDTH / 2, 80, yellow, titleFont, true);
-        menuButtons = {{{SCREEN_WIDTH / 2 - 25, 250, 100, 50}, "Play"},
-                       {{SCREEN_WIDTH / 2 - 25, 320, 100, 50}, "Instructions"},
-                       {{SCREEN_WIDTH / 2 - 25, 460, 100, 50}, "Records"},
-                       {{SCREEN_WIDTH / 2 - 25, 390, 100, 50}, "Options"}};
+        list.text("Umbraked", SCREEN_WIDTH / 2, 80, yellow, FONT_TITLE, true);
+        if (net.isActive()) list.text("Waiting for co-op partner...", SCREEN_WIDTH / 2, 180, white, FONT_BODY, true);
         for (const auto& button : menuButtons) {
-            renderText(button.text.c_str(), button.rect.x + 25, button.rect.y + 10, white, font, true);
+            list.text(button.text, button.rect.x + 25, button.rect.y + 10, white, FONT_BODY, true);
         }
     } else if (gameState == INSTRUCTIONS) {
-        renderText("Instructions", SCREEN_WIDTH / 2, 100, white, font, true);
-        renderText("A/D to move", SCREEN_WIDTH / 2, 200, white, font, true);
-        renderText("W to jump", SCREEN_WIDTH / 2, 250, white, font, true);
-        renderText("SPACE to shoot", SCREEN_WIDTH / 2, 300, white, font, true);
-        renderText("(Switch UNIKEY to E mode)", SCREEN_WIDTH / 2, 350, white, font, true);
-        menuButtons = {{{SCREEN_WIDTH / 2 - 25, 450, 100, 50}, "Back"}};
-        renderText("Back", menuButtons[0].rect.x + 25, menuButtons[0].rect.y + 10, white, font, true);
+        list.text("Instructions", SCREEN_WIDTH / 2, 100, white, FONT_BODY, true);
+        list.text("A/D to move", SCREEN_WIDTH / 2, 200, white, FONT_BODY, true);
+        list.text("W to jump", SCREEN_WIDTH / 2, 250, white, FONT_BODY, true);
+        list.text("SPACE to shoot", SCREEN_WIDTH / 2, 300, white, FONT_BODY, true);
+        list.text("(Switch UNIKEY to E mode)", SCREEN_WIDTH / 2, 350, white, FONT_BODY, true);
+        list.text("Back", menuButtons[0].rect.x + 25, menuButtons[0].rect.y + 10, white, FONT_BODY, true);
     } else if (gameState == RECORDS) {
-        renderText("Records", SCREEN_WIDTH / 2, 100, white, font, true);
-        std::string bestScoreText = "Best Score: " + std::to_string(bestScore);
-        renderText(bestScoreText.c_str(), SCREEN_WIDTH / 2, 200, white, font, true);
-        menuButtons = {{{SCREEN_WIDTH / 2 - 30, 300, 100, 50}, "Back"}};
-        renderText("Back", menuButtons[0].rect.x + 25, menuButtons[0].rect.y + 10, white, font, true);
+        list.text("Records", SCREEN_WIDTH / 2, 100, white, FONT_BODY, true);
+        list.text(frameArena.format("Best Score: %d", bestScore), SCREEN_WIDTH / 2, 170, white, FONT_BODY, true);
+        const std::vector<RunRecord>& topRuns = runHistory.getTopRuns();
+        for (int i = 0; i < RECORDS_SHOWN && i < static_cast<int>(topRuns.size()); i++) {
+            const char* runText = frameArena.format("%d. %d  (%us)", i + 1, topRuns[i].score, topRuns[i].durationTicks / 60);
+            list.text(runText, SCREEN_WIDTH / 2, 220 + i * 40, white, FONT_BODY, true);
+        }
+        list.text("Back", menuButtons[0].rect.x + 25, menuButtons[0].rect.y + 10, white, FONT_BODY, true);
     } else if (gameState == OPTIONS) {
-        renderText("Options", SCREEN_WIDTH / 2, 100, white, font, true);
-        menuButtons = {{{SCREEN_WIDTH / 2 + 50, 200, 50, 50}, musicOn ? "ON" : "OFF"},
-                       {{SCREEN_WIDTH / 2 + 50, 270, 50, 50}, sfxOn ? "ON" : "OFF"},
-                       {{SCREEN_WIDTH / 2 - 25, 340, 100, 50}, "Back"}};
-        renderText("Music:", SCREEN_WIDTH / 2 - 100, 210, white, font, false);
-        renderText(musicOn ? "ON" : "OFF", menuButtons[0].rect.x, menuButtons[0].rect.y + 10, white, font, false);
-        renderText("SFX:", SCREEN_WIDTH / 2 - 100, 280, white, font, false);
-        renderText(sfxOn ? "ON" : "OFF", menuButtons[1].rect.x, menuButtons[1].rect.y + 10, white, font, false);
-        renderText("Back", menuButtons[2].rect.x + 25, menuButtons[2].rect.y + 10, white, font, true);
+        list.text("Options", SCREEN_WIDTH / 2, 100, white, FONT_BODY, true);
+        list.text("Music:", SCREEN_WIDTH / 2 - 100, 210, white, FONT_BODY, false);
+        list.text(musicOn ? "ON" : "OFF", menuButtons[0].rect.x, menuButtons[0].rect.y + 10, white, FONT_BODY, false);
+        list.text("SFX:", SCREEN_WIDTH / 2 - 100, 280, white, FONT_BODY, false);
+        list.text(sfxOn ? "ON" : "OFF", menuButtons[1].rect.x, menuButtons[1].rect.y + 10, white, FONT_BODY, false);
+        list.text("Latency:", SCREEN_WIDTH / 2 - 100, 350, white, FONT_BODY, false);
+        list.text(audio.isLowLatency() ? "LOW" : "STD", menuButtons[2].rect.x, menuButtons[2].rect.y + 10, white, FONT_BODY, false);
+        list.text("Render:", SCREEN_WIDTH / 2 - 100, 420, white, FONT_BODY, false);
+        list.text(renderScaleNames[renderScale], menuButtons[3].rect.x, menuButtons[3].rect.y + 10, white, FONT_BODY, false);
+        list.text("Back", menuButtons[4].rect.x + 25, menuButtons[4].rect.y + 10, white, FONT_BODY, true);
     } else if (gameState == PLAYING) {
-        for (const auto& tile : tiles) {
-            SDL_Rect dest = {tile.rect.x - (int)cameraX, tile.rect.y, tile.rect.w, tile.rect.h};
-            SDL_RenderCopy(renderer, tile.isGround ? groundTexture : floatingTexture, NULL, &dest);
+        for (const auto& tile : *tiles) {
+            list.sprite(tile.isGround ? SPRITE_GROUND : SPRITE_FLOATING, {tile.rect.x - cameraX, tile.rect.y, tile.rect.w, tile.rect.h});
         }
         for (const auto& spike : spikes) {
-            SDL_Rect dest = {spike.x - (int)cameraX, spike.y, spike.w, spike.h};
-            SDL_RenderCopy(renderer, spikeTexture, NULL, &dest);
+            list.sprite(SPRITE_SPIKE, {spike.x - cameraX, spike.y, spike.w, spike.h});
         }
-        for (const auto& enemy : enemies) {
-            if (enemy.active) {
-                SDL_Rect dest = {enemy.rect.x - (int)cameraX, enemy.rect.y, enemy.rect.w, enemy.rect.h};
+        for (int type = 0; type < ENEMY_TYPE_COUNT; type++) {
+            for (const auto& enemy : enemies[type]) {
+                if (!enemy.active) continue;
                 SDL_RendererFlip flip = enemy.facingLeft ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
-                switch (enemy.type) {
-                    case 0: SDL_RenderCopyEx(renderer, enemy1Texture, NULL, &dest, 0, NULL, flip); break;
-                    case 1: SDL_RenderCopyEx(renderer, enemy2Texture, NULL, &dest, 0, NULL, flip); break;
-                    case 2: SDL_RenderCopyEx(renderer, enemy3Texture, NULL, &dest, 0, NULL, flip); break;
-                    case 3: SDL_RenderCopyEx(renderer, enemy4Texture, NULL, &dest, 0, NULL, flip); break;
-                    case 4: SDL_RenderCopyEx(renderer, enemy5Texture, NULL, &dest, 0, NULL, flip); break;
-                }
+                list.sprite(SPRITE_ENEMY + type, {enemy.rect.x - cameraX, enemy.rect.y, enemy.rect.w, enemy.rect.h}, flip);
             }
         }
-        for (const auto& bullet : bullets) {
-            if (bullet.active) {
-                SDL_Rect dest = {bullet.rect.x - (int)cameraX, bullet.rect.y, bullet.rect.w, bullet.rect.h};
-                SDL_RenderCopy(renderer, bulletTexture, NULL, &dest);
+        if (showSightLines) {
+            for (const auto& bucket : enemies) {
+                for (const auto& enemy : bucket) {
+                    if (!enemy.active || simulationTick - enemy.sightTick >= LINE_OF_SIGHT_CACHE_TICKS) continue;
+                    SDL_Color color = enemy.hasSight ? SDL_Color{0, 255, 0, 255} : SDL_Color{255, 0, 0, 255};
+                    list.line(enemy.rect.x + enemy.rect.w / 2 - cameraX, enemy.rect.y + enemy.rect.h / 2,
+                              playerRect.x + playerRect.w / 2 - cameraX, playerRect.y + playerRect.h / 2, color);
+                }
             }
         }
-        for (const auto& bullet : enemyBullets) {
+        for (const auto& bullet : projectiles.getProjectiles()) {
             if (bullet.active) {
-                SDL_Rect dest = {bullet.rect.x - (int)cameraX, bullet.rect.y, bullet.rect.w, bullet.rect.h};
-                SDL_RenderCopy(renderer, enemyBulletTexture, NULL, &dest);
+                list.sprite(bullet.team == TEAM_PLAYER ? SPRITE_BULLET : SPRITE_ENEMY_BULLET,
+                            {bullet.rect.x - cameraX, bullet.rect.y, bullet.rect.w, bullet.rect.h});
             }
         }
-        SDL_Rect playerDest = {playerRect.x - (int)cameraX, playerRect.y, playerRect.w, playerRect.h};
         SDL_RendererFlip flip = playerFlipped ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
-        if (!isInvincible || (SDL_GetTicks() % 200 < 100)) {
-            SDL_RenderCopyEx(renderer, playerTexture, NULL, &playerDest, 0, NULL, flip);
+        if (!isInvincible || simulationTick % 12 < 6) {
+            list.sprite(SPRITE_PLAYER, {playerRect.x - cameraX, playerRect.y, playerRect.w, playerRect.h}, flip);
         }
+        int firstVertex = static_cast<int>(list.getVertexBuffer().size());
+        int quads = particles.buildQuads(list.getVertexBuffer(), cameraX);
+        if (quads) list.particles(firstVertex, quads);
+        list.command(RENDER_END_WORLD);
         for (int i = 0; i < 3; i++) {
-            SDL_Rect heartRect = {10 + i * 40, 10, 32, 32};
-            SDL_RenderCopy(renderer, heartTextures[i], NULL, &heartRect);
+            list.sprite(SPRITE_HEART + (i < lives ? i : HEART_TEXTURE_COUNT - 1), {10 + i * 40, 10, 32, 32});
         }
-        std::string scoreText = "Score: " + std::to_string(score);
-        renderText(scoreText.c_str(), SCREEN_WIDTH - 400, 10, black, scoreFont);
+        list.text(frameArena.format("Score: %d", score), SCREEN_WIDTH - 400, 10, black, FONT_SCORE);
+        if (net.isConnected()) list.text(net.getRole() == NET_HOST ? "P1: move" : "P2: shoot", 10, 50, white, FONT_BODY);
+        if (paused) list.text("PAUSED", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 - 30, white, FONT_BODY, true);
     } else if (gameState == GAME_OVER) {
-        renderText("GAME OVER", SCREEN_WIDTH / 2, 100, white, font, true);
-        std::string scoreText = "Score: " + std::to_string(score);
-        renderText(scoreText.c_str(), SCREEN_WIDTH / 2, 150, white, font, true);
-        menuButtons = {{{SCREEN_WIDTH / 2 - 25, 270, 100, 50}, "Play Again"},
-                       {{SCREEN_WIDTH / 2 - 25, 340, 100, 50}, "Main Menu"},
-                       {{SCREEN_WIDTH / 2 - 25, 410, 100, 50}, "Exit"}};
+        list.text("GAME OVER", SCREEN_WIDTH / 2, 100, white, FONT_BODY, true);
+        list.text(frameArena.format("Score: %d", score), SCREEN_WIDTH / 2, 150, white, FONT_BODY, true);
         for (const auto& button : menuButtons) {
-            renderText(button.text.c_str(), button.rect.x + 25, button.rect.y + 10, white, font, true);
+            list.text(button.text, button.rect.x + 25, button.rect.y + 10, white, FONT_BODY, true);
         }
     }
+}
 
+void Game::submitRenderList(const RenderList& list) {
+    PROFILE_ZONE("Game::submitRenderList");
+    ALLOC_PHASE(ALLOC_PHASE_RENDER);
+    if (list.scaleMode != renderScaler.getMode()) renderScaler.setMode(list.scaleMode);
+    textCache.nextFrame();
+    SDL_RenderClear(renderer);
+    for (const auto& command : list.getCommands()) {
+        switch (command.op) {
+            case RENDER_SPRITE:
+                draw(sprites[command.id].get(), &command.rect, static_cast<SDL_RendererFlip>(command.flip));
+                break;
+            case RENDER_TEXT:
+                renderText(list.getText(command.text), command.rect.x, command.rect.y, command.color,
+                           fonts[command.id].get(), command.center != 0);
+                break;
+            case RENDER_LINE:
+                SDL_SetRenderDrawColor(renderer, command.color.r, command.color.g, command.color.b, command.color.a);
+                SDL_RenderDrawLine(renderer, command.rect.x, command.rect.y, command.rect.w, command.rect.h);
+                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+                drawCalls++;
+                break;
+            case RENDER_BEGIN_WORLD: renderScaler.beginWorld(); break;
+            case RENDER_END_WORLD: renderScaler.endWorld(); break;
+            case RENDER_PARTICLES:
+                particles.render(renderer, list.getVertices(command.rect.x), command.rect.w);
+                drawCalls++;
+                break;
+        }
+    }
     SDL_RenderPresent(renderer);
 }
 
+void Game::draw(SDL_Texture* texture, const SDL_Rect* dest, SDL_RendererFlip flip) {
+    drawCalls++;
+    if (flip == SDL_FLIP_NONE) SDL_RenderCopy(renderer, texture, NULL, dest);
+    else SDL_RenderCopyEx(renderer, texture, NULL, dest, 0, NULL, flip);
+}
+
 void Game::renderText(const char* text, int x, int y, SDL_Color color, TTF_Font* font, bool center) {
-    SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
-    if (!surface) return;
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!texture) { SDL_FreeSurface(surface); return; }
-    SDL_Rect rect = {x, y, surface->w, surface->h};
-    if (center) rect.x -= surface->w / 2;
-    SDL_RenderCopy(renderer, texture, NULL, &rect);
-    SDL_DestroyTexture(texture);
-    SDL_FreeSurface(surface);
+    PROFILE_ZONE("Game::renderText");
+    int width, height;
+    SDL_Texture* texture = textCache.get(text, color, font, width, height);
+    if (!texture) return;
+    SDL_Rect rect = {x, y, width, height};
+    if (center) rect.x -= width / 2;
+    draw(texture, &rect);
 }
 
 void Game::generateWorld() {
-    static float spawnThreshold = 0.9f;
+    PROFILE_ZONE("Game::generateWorld");
+    PERF_SCOPE(PERF_WORLDGEN);
+    catchUpEnemies();
+    const int spawnThreshold = baseSpawnThreshold;
+    int chunkLeft = lastGeneratedX;
 
     for (int y = 0; y < 3; y++) {
         for (int x = lastGeneratedX; x < lastGeneratedX + SCREEN_WIDTH + TILE_SIZE * 10; x += TILE_SIZE) {
-            tiles.push_back({{x, y * TILE_SIZE, TILE_SIZE, TILE_SIZE}, true});
+            addTile({x, y * TILE_SIZE, TILE_SIZE, TILE_SIZE}, true);
         }
     }
 
-    if (spawnDist(gen) < 0.25f) {
-        groundHeight += (rand() % 3 - 1) * TILE_SIZE;
-        groundHeight = std::max(TILE_SIZE * 3, std::min(SCREEN_HEIGHT - TILE_SIZE * 3, groundHeight));
+    if (chance(250)) {
+        groundHeight += (randomInt(3) - 1) * TILE_SIZE;
+        groundHeight = std::max(GROUND_MIN_Y, std::min(SCREEN_HEIGHT - TILE_SIZE * 3, groundHeight));
     }
 
-    int segmentLength = TILE_SIZE * (rand() % 6 + 5);
+    int segmentLength = TILE_SIZE * (randomInt(6) + 5);
     for (int y = 0; y < 3; y++) {
         for (int x = 0; x < segmentLength / TILE_SIZE; x++) {
-            tiles.push_back({{lastGeneratedX + x * TILE_SIZE, groundHeight + y * TILE_SIZE, TILE_SIZE, TILE_SIZE}, true});
+            addTile({lastGeneratedX + x * TILE_SIZE, groundHeight + y * TILE_SIZE, TILE_SIZE, TILE_SIZE}, true);
         }
     }
 
-    if (lastGeneratedX > SCREEN_WIDTH && spawnDist(gen) < spawnThreshold) {
+    if (lastGeneratedX > SCREEN_WIDTH && chance(spawnThreshold)) {
         int spawnX1 = lastGeneratedX + segmentLength / 3;
         int spawnX2 = lastGeneratedX + segmentLength * 2 / 3;
         if (std::abs(spawnX1 - playerRect.x) > MIN_ENEMY_SPAWN_DISTANCE) {
             spawnEnemy(spawnX1, groundHeight - 40);
         }
-        if (spawnDist(gen) < spawnThreshold * 0.6f && std::abs(spawnX2 - playerRect.x) > MIN_ENEMY_SPAWN_DISTANCE) {
+        if (chance(spawnThreshold * 6 / 10) && std::abs(spawnX2 - playerRect.x) > MIN_ENEMY_SPAWN_DISTANCE) {
             spawnEnemy(spawnX2, groundHeight - 40);
         }
     }
     lastGeneratedX += segmentLength;
 
-    float roll = spawnDist(gen);
-    if (roll < 0.2f) {
-        int gapWidth = TILE_SIZE * (rand() % 3 + 2);
+    int roll = randomInt(1000);
+    if (roll < 200) {
+        int gapWidth = TILE_SIZE * (randomInt(3) + 2);
         if (gapWidth > MAX_JUMP_DISTANCE) {
             int numPlatforms = (gapWidth + MAX_JUMP_DISTANCE - 1) / MAX_JUMP_DISTANCE;
             int platformSpacing = gapWidth / (numPlatforms + 1);
             int prevY = groundHeight;
             for (int i = 1; i <= numPlatforms; i++) {
                 int platformX = lastGeneratedX + platformSpacing * i;
-                int platformY = prevY - TILE_SIZE * (rand() % 3 + 1);
-                platformY = std::max(SCREEN_HEIGHT / 4, platformY);
-                int platformWidth = TILE_SIZE * (rand() % 2 + 1);
+                int platformY = prevY - TILE_SIZE * (randomInt(3) + 1);
+                platformY = std::max(PLATFORM_MIN_Y, platformY);
+                int platformWidth = TILE_SIZE * (randomInt(2) + 1);
                 for (int j = 0; j < platformWidth / TILE_SIZE; j++) {
-                    tiles.push_back({{platformX + j * TILE_SIZE, platformY, TILE_SIZE, TILE_SIZE}, false});
+                    addTile({platformX + j * TILE_SIZE, platformY, TILE_SIZE, TILE_SIZE}, false);
                 }
 
-                if (lastGeneratedX > SCREEN_WIDTH && spawnDist(gen) < spawnThreshold * 0.8f && numPlatforms > 1 &&
+                if (lastGeneratedX > SCREEN_WIDTH && chance(spawnThreshold * 8 / 10) && numPlatforms > 1 &&
                     std::abs(platformX + platformWidth / 2 - playerRect.x) > MIN_ENEMY_SPAWN_DISTANCE) {
                     spawnEnemy(platformX + platformWidth / 2, platformY - 40);
                 }
@@ -479,39 +1160,39 @@ void Game::generateWorld() {
             }
         }
         lastGeneratedX += gapWidth;
-    } else if (roll < 0.45f) {
-        int pipeHeight = TILE_SIZE * (rand() % 3 + 2);
+    } else if (roll < 450) {
+        int pipeHeight = TILE_SIZE * (randomInt(3) + 2);
         int pipeWidth = TILE_SIZE * 2;
         for (int y = 0; y < pipeHeight / TILE_SIZE; y++) {
             for (int x = 0; x < pipeWidth / TILE_SIZE; x++) {
-                tiles.push_back({{lastGeneratedX + x * TILE_SIZE, groundHeight - pipeHeight + y * TILE_SIZE, TILE_SIZE, TILE_SIZE}, true});
+                addTile({lastGeneratedX + x * TILE_SIZE, groundHeight - pipeHeight + y * TILE_SIZE, TILE_SIZE, TILE_SIZE}, true);
             }
         }
-        if (lastGeneratedX > SCREEN_WIDTH && spawnDist(gen) < spawnThreshold * 0.8f &&
+        if (lastGeneratedX > SCREEN_WIDTH && chance(spawnThreshold * 8 / 10) &&
             std::abs(lastGeneratedX + pipeWidth / 2 - playerRect.x) > MIN_ENEMY_SPAWN_DISTANCE) {
             spawnEnemy(lastGeneratedX + pipeWidth / 2, groundHeight - pipeHeight - 40);
         }
         lastGeneratedX += pipeWidth + TILE_SIZE * 2;
-    } else if (roll < 0.85f) {
-        int numPlatforms = rand() % 3 + 2;
-        int totalWidth = TILE_SIZE * (rand() % 4 + 3);
+    } else if (roll < 850) {
+        int numPlatforms = randomInt(3) + 2;
+        int totalWidth = TILE_SIZE * (randomInt(4) + 3);
         int platformSpacing = totalWidth / numPlatforms;
         int maxHeightDiff = 4 * TILE_SIZE;
         int prevX = lastGeneratedX;
         int prevY = groundHeight;
         for (int i = 0; i < numPlatforms; i++) {
             int platformX = prevX + platformSpacing;
-            int platformY = prevY - TILE_SIZE * (rand() % 3 + 1);
+            int platformY = prevY - TILE_SIZE * (randomInt(3) + 1);
             if (prevY - platformY > maxHeightDiff) platformY = prevY - maxHeightDiff;
-            platformY = std::max(SCREEN_HEIGHT / 4, platformY);
-            int platformWidth = TILE_SIZE * (rand() % 2 + 1);
+            platformY = std::max(PLATFORM_MIN_Y, platformY);
+            int platformWidth = TILE_SIZE * (randomInt(2) + 1);
             for (int j = 0; j < platformWidth / TILE_SIZE; j++) {
-                tiles.push_back({{platformX + j * TILE_SIZE, platformY, TILE_SIZE, TILE_SIZE}, false});
+                addTile({platformX + j * TILE_SIZE, platformY, TILE_SIZE, TILE_SIZE}, false);
             }
-            if (lastGeneratedX > SCREEN_WIDTH && spawnDist(gen) < spawnThreshold * 0.8f && numPlatforms > 1 &&
+            if (lastGeneratedX > SCREEN_WIDTH && chance(spawnThreshold * 8 / 10) && numPlatforms > 1 &&
                 std::abs(platformX + platformWidth / 2 - playerRect.x) > MIN_ENEMY_SPAWN_DISTANCE) {
                 spawnEnemy(platformX + platformWidth / 2, platformY - 40);
-                if (platformWidth > TILE_SIZE && spawnDist(gen) < spawnThreshold * 0.4f) {
+                if (platformWidth > TILE_SIZE && chance(spawnThreshold * 4 / 10)) {
                     spawnEnemy(platformX, platformY - 40);
                 }
             }
@@ -520,12 +1201,12 @@ void Game::generateWorld() {
         }
         lastGeneratedX += totalWidth + TILE_SIZE * 2;
     } else {
-        if (lastGeneratedX > SCREEN_WIDTH && spawnDist(gen) < spawnThreshold) {
+        if (lastGeneratedX > SCREEN_WIDTH && chance(spawnThreshold)) {
             int spawnX = lastGeneratedX + TILE_SIZE;
             if (std::abs(spawnX - playerRect.x) > MIN_ENEMY_SPAWN_DISTANCE) {
                 spawnEnemy(spawnX, groundHeight - 40);
             }
-            if (spawnDist(gen) < spawnThreshold * 0.5f) {
+            if (chance(spawnThreshold * 5 / 10)) {
                 int spawnX2 = lastGeneratedX + TILE_SIZE * 2;
                 if (std::abs(spawnX2 - playerRect.x) > MIN_ENEMY_SPAWN_DISTANCE) {
                     spawnEnemy(spawnX2, groundHeight - 40);
@@ -534,36 +1215,83 @@ void Game::generateWorld() {
         }
         lastGeneratedX += TILE_SIZE * 3;
     }
-    if (lastGeneratedX > SCREEN_WIDTH && spawnDist(gen) < spawnThreshold * 0.7f) {
+    if (lastGeneratedX > SCREEN_WIDTH && chance(spawnThreshold * 7 / 10)) {
         int soloBlockX = lastGeneratedX - segmentLength / 2;
-        int soloBlockY = groundHeight - TILE_SIZE * (rand() % 4 + 1);
+        int soloBlockY = groundHeight - TILE_SIZE * (randomInt(4) + 1);
         if (soloBlockY < groundHeight - 4 * TILE_SIZE) {
-            tiles.push_back({{soloBlockX, soloBlockY, TILE_SIZE, TILE_SIZE}, false});
-            if (spawnDist(gen) < spawnThreshold * 0.6f && std::abs(soloBlockX - playerRect.x) > MIN_ENEMY_SPAWN_DISTANCE) {
+            addTile({soloBlockX, soloBlockY, TILE_SIZE, TILE_SIZE}, false);
+            if (chance(spawnThreshold * 6 / 10) && std::abs(soloBlockX - playerRect.x) > MIN_ENEMY_SPAWN_DISTANCE) {
                 spawnEnemy(soloBlockX, soloBlockY - 40);
             }
         }
     }
+    validateChunk(chunkLeft);
+    navGraph.edit().addChunk(*terrain, chunkLeft, lastGeneratedX);
+}
+
+int Game::chunkExitY() const {
+    return std::max(TILE_SIZE * 3, groundHeight - TILE_SIZE);
+}
+
+void Game::validateChunk(int chunkLeft) {
+    reachStats.chunks++;
+    int exitY = chunkExitY();
+    for (int patches = 0; !reachability.check(*terrain, chunkLeft, lastGeneratedX, exitY); patches++) {
+        SDL_Rect block;
+        if (patches == REACH_MAX_PATCHES || !reachability.findPatch(*terrain, exitY, block)) {
+            reachStats.failed++;
+            return;
+        }
+        for (int x = 0; x < block.w; x += TILE_SIZE) addTile({block.x + x, block.y, TILE_SIZE, TILE_SIZE}, false);
+        if (patches == 0) reachStats.patched++;
+    }
 }
 
 void Game::resetGame() {
+    resetGame(std::random_device()());
+}
+
+void Game::resetGame(Uint32 seed) {
+    PERF_SCOPE(PERF_RESET);
+    paused = false;
     isJumping = false;
     isOnGround = true;
+    isSpacePressed = false;
+    spaceTapped = false;
+    playerFlipped = false;
+    // World generation keeps enemies away from the player, so it must see the same start position every run.
+    playerRect = {PLAYER_START_X, PLAYER_START_Y, PLAYER_WIDTH, PLAYER_HEIGHT};
+    playerPosX = toFixed(PLAYER_START_X);
+    playerPosY = toFixed(PLAYER_START_Y);
     playerVelX = 0;
     playerVelY = 0;
     score = 0;
     cameraX = 0;
     maxPlayerX = 0;
+    currentSpawnThreshold = baseSpawnThreshold;
+    lastDifficultyThreshold = 0;
     shootCooldown = 0;
     groundHeight = GROUND_HEIGHT;
     lastGeneratedX = 0;
     lives = 3;
-    invincibilityTimer = SDL_GetTicks() + 2000;
+    simulationTick = 0;
+    runSeed = seed;
+    gen.seed(runSeed);
+    particles.reset(runSeed);
+    if (replayMode == REPLAY_OFF && !simulationOnly) replay.beginRecording(runSeed);
+    invincibilityTimer = simulationTick + INVINCIBILITY_TICKS;
     isInvincible = true;
-    tiles.clear();
-    bullets.clear();
-    enemyBullets.clear();
-    enemies.clear();
+    tiles.edit().clear();
+    tiles.edit().reserve(TILE_RESERVE);
+    terrain.edit().clear();
+    navGraph.edit().clear();
+    navField.invalidate();
+    hasCheckpoint = false;
+    projectiles.clear();
+    for (auto& bucket : enemies) {
+        bucket.clear();
+        bucket.reserve(ENEMY_RESERVE);
+    }
 
     if (spikes.empty()) {
         for (int y = 0; y < SCREEN_HEIGHT; y += TILE_SIZE) {
@@ -573,16 +1301,9 @@ void Game::resetGame() {
         for (auto& spike : spikes) spike.x = 0;
     }
 
-    SDL_Surface* surface = IMG_Load(LIVE_IMAGE_PATH);
-    SDL_Texture* liveTexture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    heartTextures[0] = liveTexture;
-    heartTextures[1] = liveTexture;
-    heartTextures[2] = liveTexture;
-
     for (int i = 0; i < 30; i++) generateWorld();
     std::vector<Tile> groundTiles;
-    for (const auto& tile : tiles) {
+    for (const auto& tile : *tiles) {
         if (tile.isGround) {
             groundTiles.push_back(tile);
         }
@@ -662,252 +1383,410 @@ void Game::resetGame() {
     }
 
     playerRect = {spawnX, spawnY, PLAYER_WIDTH, PLAYER_HEIGHT};
+    playerPosX = toFixed(spawnX);
+    playerPosY = toFixed(spawnY);
 }
+
+void Game::syncPlayerRect() {
+    playerRect.x = fixedToInt(playerPosX);
+    playerRect.y = fixedToInt(playerPosY);
+}
+
 void Game::fireBullet() {
-    bullets.push_back({{playerRect.x + (playerFlipped ? 0 : playerRect.w), playerRect.y + playerRect.h / 2 - 2, 10, 5},
-                       10.0f, true, playerFlipped, 0, playerRect.x + (playerFlipped ? 0 : playerRect.w)});
-    playSFX(shootSound);
+    int muzzleX = playerRect.x + (playerFlipped ? 0 : playerRect.w);
+    SDL_Rect rect = {muzzleX, playerRect.y + playerRect.h / 2 - 2, BULLET_WIDTH, BULLET_HEIGHT};
+    projectiles.spawn(TEAM_PLAYER, rect, playerFlipped ? -PLAYER_BULLET_SPEED : PLAYER_BULLET_SPEED);
+    emitParticles(rect, PARTICLE_MUZZLE, playerFlipped);
+    playSFX(shootSound.get());
 }
 
 void Game::spawnEnemy(int x, int y) {
-    static float spawnThreshold = 0.9f;
-    if (spawnDist(gen) >= spawnThreshold) return;
+    if (!chance(baseSpawnThreshold)) return;
 
     Enemy enemy;
-    enemy.type = rand() % 5;
-    int baseHeight = (enemy.type == 3) ? 40 : 30;
-    int width = (enemy.type == 3) ? static_cast<int>(baseHeight * enemy4AspectRatio) :
-                (enemy.type == 4) ? static_cast<int>(baseHeight * enemy5AspectRatio) : 30;
+    enemy.type = randomInt(ENEMY_TYPE_COUNT);
+    const EnemyTypeInfo& info = ENEMY_TYPES[enemy.type];
+    int baseHeight = info.height;
+    int width = enemyWidth(enemy.type);
 
     if (!canSpawnEnemy(x, y, width, baseHeight)) return;
 
     int adjustedY = y;
-    for (const auto& tile : tiles) {
-        if (tile.rect.x <= x + width && tile.rect.x + tile.rect.w >= x &&
-            tile.rect.y >= y && tile.rect.y <= y + baseHeight + TILE_SIZE) {
-            adjustedY = tile.rect.y - baseHeight;
-            break;
-        }
-    }
+    int surfaceY;
+    if (terrain->findSurface(x, x + width, y, y + baseHeight + TILE_SIZE, surfaceY)) adjustedY = surfaceY - baseHeight;
 
     enemy.rect = {x, adjustedY, width, baseHeight};
-    enemy.speed = (enemy.type <= 1) ? 1.5f : 2.0f;
+    enemy.positionX = toFixed(x);
+    enemy.positionY = toFixed(adjustedY);
     enemy.active = true;
-    enemy.facingLeft = rand() % 2;
+    enemy.facingLeft = randomInt(2);
     enemy.shootCooldown = 0;
-    enemy.detectionRange = 200.0f;
+    enemy.detectionRange = ENEMY_DETECTION_RANGE;
+    enemy.velocityX = 0;
     enemy.velocityY = 0;
-    enemies.push_back(enemy);
+    std::vector<Enemy>& bucket = enemies[enemy.type];
+    enemy.updateSlot = static_cast<int>(bucket.size()) % ENEMY_THROTTLED_INTERVAL;
+    enemy.pendingTicks = 0;
+    enemy.sightTick = -LINE_OF_SIGHT_CACHE_TICKS;
+    enemy.hasSight = false;
+    enemy.navNode = -1;
+    enemy.navEdge = -1;
+    enemy.navSlot = static_cast<int>(bucket.size()) % NAV_REPATH_INTERVAL;
+    bucket.push_back(enemy);
 }
 
-bool Game::canSpawnEnemy(int x, int y, int width, int height) {
-    SDL_Rect enemyRect = {x, y, width, height};
-    SDL_Rect groundCheck = {x, y + height, width, TILE_SIZE};
-
-    bool hasGround = false;
-    for (const auto& tile : tiles) {
-        if (checkCollision(groundCheck, tile.rect)) {
-            hasGround = true;
-            break;
-        }
-    }
-    if (!hasGround) return false;
+int Game::enemyWidth(int type) const {
+    return enemyWidths[type];
+}
 
-    for (const auto& tile : tiles) {
-        if (checkCollision(enemyRect, tile.rect)) return false;
+void Game::loadCollisionMasks() {
+    spriteMasks[SPRITE_PLAYER].load(spritePaths[SPRITE_PLAYER], PLAYER_WIDTH, PLAYER_HEIGHT);
+    spriteMasks[SPRITE_BULLET].load(spritePaths[SPRITE_BULLET], BULLET_WIDTH, BULLET_HEIGHT);
+    spriteMasks[SPRITE_ENEMY_BULLET].load(spritePaths[SPRITE_ENEMY_BULLET], BULLET_WIDTH, BULLET_HEIGHT);
+    for (int type = 0; type < ENEMY_TYPE_COUNT; type++) {
+        spriteMasks[SPRITE_ENEMY + type].load(spritePaths[SPRITE_ENEMY + type], enemyWidth(type), ENEMY_TYPES[type].height);
     }
+}
 
-    SDL_Rect leftCheck = {x - TILE_SIZE, y + height, TILE_SIZE, TILE_SIZE};
-    SDL_Rect rightCheck = {x + width, y + height, TILE_SIZE, TILE_SIZE};
+void Game::copyCollisionMasks(const Game& other) {
+    for (int id = 0; id < SPRITE_COUNT; id++) spriteMasks[id] = other.spriteMasks[id];
+}
 
-    bool hasLeftPlatform = false;
-    bool hasRightPlatform = false;
+void Game::setEnemySpriteSize(int type, int width, int height) {
+    const EnemyTypeInfo& info = ENEMY_TYPES[type];
+    if (info.keepsAspect && width > 0 && height > 0) enemyWidths[type] = info.height * width / height;
+}
 
-    for (const auto& tile : tiles) {
-        if (checkCollision(leftCheck, tile.rect)) hasLeftPlatform = true;
-        if (checkCollision(rightCheck, tile.rect)) hasRightPlatform = true;
-    }
+bool Game::canSpawnEnemy(int x, int y, int width, int height) {
+    SDL_Rect enemyRect = {x, y, width, height};
+    SDL_Rect groundCheck = {x, y + height, width, TILE_SIZE};
+    if (!terrain->overlaps(groundCheck) || terrain->overlaps(enemyRect)) return false;
 
-    return hasLeftPlatform && hasRightPlatform;
+    SDL_Rect leftCheck = {x - TILE_SIZE, y + height, TILE_SIZE, TILE_SIZE};
+    SDL_Rect rightCheck = {x + width, y + height, TILE_SIZE, TILE_SIZE};
+    return terrain->overlaps(leftCheck) && terrain->overlaps(rightCheck);
 }
 
-void Game::updateEnemies() {
-    static float enemyBulletSpeed = 3.0f;
-
-    for (auto& enemy : enemies) {
+template <int Type>
+void Game::updateEnemyBucket(Fixed enemyBulletSpeed) {
+    typedef EnemyTraits<Type> Traits;
+    for (auto& enemy : enemies[Type]) {
         if (!enemy.active) continue;
 
-        enemy.velocityY += GRAVITY;
-        enemy.rect.y += enemy.velocityY;
-
-        bool onGround = false;
-        for (const auto& tile : tiles) {
-            if (checkCollision(enemy.rect, tile.rect)) {
-                if (enemy.velocityY > 0 && enemy.rect.y + enemy.rect.h - enemy.velocityY <= tile.rect.y) {
-                    enemy.rect.y = tile.rect.y - enemy.rect.h;
-                    enemy.velocityY = 0;
-                    onGround = true;
-                } else if (enemy.velocityY < 0 && enemy.rect.y - enemy.velocityY >= tile.rect.y + tile.rect.h) {
-                    enemy.rect.y = tile.rect.y + tile.rect.h;
-                    enemy.velocityY = 0;
-                }
+        EnemyActivity activity = getEnemyActivity<Type>(enemy);
+        if (activity != ENEMY_ACTIVE) {
+            enemy.pendingTicks++;
+            if (activity == ENEMY_THROTTLED && (simulationTick + enemy.updateSlot) % ENEMY_THROTTLED_INTERVAL == 0) {
+                catchUpEnemy<Type>(enemy);
             }
+            continue;
         }
+        catchUpEnemy<Type>(enemy);
+        if (!enemy.active) continue;
 
-        if (onGround) {
-            int moveX = enemy.facingLeft ? -enemy.speed : enemy.speed;
-            SDL_Rect futureRect = enemy.rect;
-            futureRect.x += moveX;
+        bool onGround = fallEnemy(enemy, *tiles);
+        if (!enemy.active) continue;
 
-            bool willCollide = false;
-            for (const auto& tile : tiles) {
-                if (checkCollision(futureRect, tile.rect)) {
-                    willCollide = true;
-                    break;
-                }
+        if (Traits::chases && !onGround && enemy.velocityX != 0) {
+            SDL_Rect futureRect = enemy.rect;
+            futureRect.x = fixedToInt(enemy.positionX + enemy.velocityX);
+            if (terrain->overlaps(futureRect)) {
+                enemy.velocityX = 0;
+            } else {
+                enemy.positionX += enemy.velocityX;
+                enemy.rect.x = fixedToInt(enemy.positionX);
             }
+        }
 
-            SDL_Rect frontCheck = {enemy.facingLeft ? enemy.rect.x - 1 : enemy.rect.x + enemy.rect.w,
-                                   enemy.rect.y + enemy.rect.h, 1, 1};
-            bool hasPlatformAhead = false;
-            for (const auto& tile : tiles) {
-                if (checkCollision(frontCheck, tile.rect)) {
-                    hasPlatformAhead = true;
-                    break;
-                }
+        if (onGround) {
+            const NavEdge* edge = nullptr;
+            bool chasing = false;
+            if (Traits::chases) {
+                enemy.velocityX = 0;
+                edge = planChase(enemy);
+                chasing = edge || (enemy.navNode >= 0 && enemy.navNode == navField.getTarget());
             }
 
-            if (willCollide || !hasPlatformAhead) {
-                enemy.facingLeft = !enemy.facingLeft;
+            if (chasing) {
+                int center = enemy.rect.x + enemy.rect.w / 2;
+                int goalX = edge ? edge->takeoffX : playerRect.x + playerRect.w / 2;
+                int step = fixedToInt(Traits::speed);
+                int direction = goalX - center > step ? 1 : (center - goalX > step ? -1 : 0);
+                if (edge && edge->type != NAV_JUMP) direction = edge->direction;
+                if (direction != 0) enemy.facingLeft = direction < 0;
+
+                SDL_Rect futureRect = enemy.rect;
+                futureRect.x = fixedToInt(enemy.positionX + direction * Traits::speed);
+                bool blocked = direction == 0 || terrain->overlaps(futureRect);
+                bool atLedge = !edge && !terrain->isSolidAt(direction < 0 ? enemy.rect.x - 1 : enemy.rect.x + enemy.rect.w,
+                                                            enemy.rect.y + enemy.rect.h);
+                if (edge && edge->type == NAV_JUMP && blocked) {
+                    enemy.facingLeft = edge->direction < 0;
+                    enemy.velocityY = JUMP_FORCE;
+                    enemy.velocityX = edge->direction * edge->airSpeed;
+                } else if (!blocked && !atLedge) {
+                    enemy.positionX += direction * Traits::speed;
+                    enemy.rect.x = fixedToInt(enemy.positionX);
+                    if (edge && edge->type == NAV_DROP &&
+                        edge->direction * (enemy.rect.x + enemy.rect.w / 2 - edge->takeoffX) >= 0) {
+                        enemy.velocityX = edge->direction * edge->airSpeed;
+                    }
+                }
             } else {
-                enemy.rect.x += moveX;
+                patrolEnemy<Type>(enemy);
             }
 
-            float distanceToPlayer = std::abs(playerRect.x + playerRect.w / 2 - (enemy.rect.x + enemy.rect.w / 2));
-            if (distanceToPlayer < enemy.detectionRange && enemy.shootCooldown <= 0) {
-                enemyBullets.push_back({{enemy.rect.x + (enemy.facingLeft ? 0 : enemy.rect.w), enemy.rect.y + enemy.rect.h / 2 - 2, 10, 5},
-                                        enemyBulletSpeed + (enemy.type <= 1 ? 0 : 1.0f), true, enemy.facingLeft, 0,
-                                        enemy.rect.x + (enemy.facingLeft ? 0 : enemy.rect.w)});
-                enemy.shootCooldown = (enemy.type <= 1) ? 60 : 45;
+            int distanceToPlayer = std::abs(playerRect.x + playerRect.w / 2 - (enemy.rect.x + enemy.rect.w / 2));
+            if (distanceToPlayer < enemy.detectionRange && enemy.shootCooldown <= 0 && canSeePlayer(enemy)) {
+                int muzzleX = enemy.rect.x + (enemy.facingLeft ? 0 : enemy.rect.w);
+                Fixed bulletSpeed = enemyBulletSpeed + Traits::bulletSpeedBonus;
+                projectiles.spawn(TEAM_ENEMY, {muzzleX, enemy.rect.y + enemy.rect.h / 2 - 2, BULLET_WIDTH, BULLET_HEIGHT},
+                                  enemy.facingLeft ? -bulletSpeed : bulletSpeed);
+                enemy.shootCooldown = Traits::shotCooldown;
             } else if (enemy.shootCooldown > 0) {
                 enemy.shootCooldown--;
             }
         }
 
-        for (auto& bullet : bullets) {
-            if (bullet.active && checkCollision(bullet.rect, enemy.rect)) {
-                bullet.active = false;
-                enemy.active = false;
-                playSFX(boomSound);
-                break;
-            }
+        const CollisionMask* enemyMask = &spriteMasks[SPRITE_ENEMY + Type];
+        if (projectiles.hit(TEAM_PLAYER, enemy.rect, enemyMask, enemy.facingLeft)) {
+            enemy.active = false;
+            emitParticles(enemy.rect, PARTICLE_EXPLOSION);
+            playSFX(boomSound.get());
         }
 
-        if (checkCollision(playerRect, enemy.rect) && !isInvincible) {
+        if (!isInvincible && CollisionMask::overlaps(playerRect, &spriteMasks[SPRITE_PLAYER], playerFlipped,
+                                                     enemy.rect, enemyMask, enemy.facingLeft)) {
             if (playerRect.y + playerRect.h < enemy.rect.y + enemy.rect.h / 2 && playerVelY > 0) {
                 enemy.active = false;
                 playerVelY = JUMP_FORCE / 2;
-                playSFX(boomSound);
+                emitParticles(enemy.rect, PARTICLE_EXPLOSION);
+                playSFX(boomSound.get());
             } else {
                 lives--;
-                playSFX(hitSound);
-                heartTextures[lives] = heartTextures[3];
-                invincibilityTimer = SDL_GetTicks() + 2000;
+                emitParticles(playerRect, PARTICLE_HIT);
+                playSFX(hitSound.get());
+                invincibilityTimer = simulationTick + INVINCIBILITY_TICKS;
                 isInvincible = true;
                 if (lives <= 0) {
-                    if (score > bestScore) { bestScore = score; saveBestScore(); }
-                    gameState = GAME_OVER;
+                    endRun(DEATH_ENEMY);
                 }
             }
         }
     }
+}
 
-    for (auto& bullet : enemyBullets) {
-        if (bullet.active) {
-            bullet.rect.x += bullet.facingLeft ? -bullet.speed : bullet.speed;
-            bullet.distanceTraveled = std::abs(bullet.rect.x - bullet.startX);
-            if (bullet.distanceTraveled > BULLET_MAX_DISTANCE) bullet.active = false;
-            for (const auto& tile : tiles) {
-                if (checkCollision(bullet.rect, tile.rect)) { bullet.active = false; break; }
-            }
-            if (bullet.rect.x < cameraX || bullet.rect.x > cameraX + SCREEN_WIDTH) bullet.active = false;
-            if (checkCollision(playerRect, bullet.rect) && !isInvincible) {
-                bullet.active = false;
-                lives--;
-                playSFX(hitSound);
-                heartTextures[lives] = heartTextures[3];
-                invincibilityTimer = SDL_GetTicks() + 2000;
-                isInvincible = true;
-                if (lives <= 0) {
-                    if (score > bestScore) { bestScore = score; saveBestScore(); }
-                    gameState = GAME_OVER;
-                }
+void Game::updateEnemies() {
+    PROFILE_ZONE("Game::updateEnemies");
+    PERF_SCOPE(PERF_ENEMIES);
+    navField.update(*navGraph, navGraph->findNode(playerRect.x, playerRect.x + playerRect.w,
+                                                   playerRect.y + playerRect.h, SCREEN_HEIGHT));
+    forEachEnemyType([this](auto type) { this->template updateEnemyBucket<decltype(type)::value>(ENEMY_BULLET_SPEED); });
+
+    projectiles.update(TEAM_ENEMY, *tiles, cameraX);
+    if (!isInvincible && projectiles.hit(TEAM_ENEMY, playerRect, &spriteMasks[SPRITE_PLAYER], playerFlipped)) {
+        lives--;
+        emitParticles(playerRect, PARTICLE_HIT);
+        playSFX(hitSound.get());
+        invincibilityTimer = simulationTick + INVINCIBILITY_TICKS;
+        isInvincible = true;
+        if (lives <= 0) {
+            endRun(DEATH_ENEMY_BULLET);
+        }
+    }
+}
+
+bool Game::hasLineOfSight(const SDL_Rect& from, const SDL_Rect& to) const {
+    return terrain->hasLineOfSight(from.x + from.w / 2, from.y + from.h / 2, to.x + to.w / 2, to.y + to.h / 2);
+}
+
+bool Game::canSeePlayer(Enemy& enemy) {
+    if (simulationTick - enemy.sightTick >= LINE_OF_SIGHT_CACHE_TICKS) {
+        enemy.hasSight = hasLineOfSight(enemy.rect, playerRect);
+        enemy.sightTick = simulationTick;
+    }
+    return enemy.hasSight;
+}
+
+const NavEdge* Game::planChase(Enemy& enemy) {
+    const NavNode* node = navGraph->node(enemy.navNode);
+    bool onNode = node && node->y == enemy.rect.y + enemy.rect.h &&
+                  node->right > enemy.rect.x && node->left < enemy.rect.x + enemy.rect.w;
+    bool scheduled = (simulationTick + enemy.navSlot) % NAV_REPATH_INTERVAL == 0;
+    if (!onNode && (node || scheduled)) {
+        enemy.navNode = navGraph->findNode(enemy.rect.x, enemy.rect.x + enemy.rect.w, enemy.rect.y + enemy.rect.h, 0);
+        scheduled = true;
+    }
+    if (scheduled) enemy.navEdge = navField.bestEdge(*navGraph, enemy.navNode);
+    node = navGraph->node(enemy.navNode);
+    if (!node || enemy.navEdge < 0 || enemy.navEdge >= static_cast<int>(node->edges.size())) return nullptr;
+    return &node->edges[enemy.navEdge];
+}
+
+template <int Type>
+EnemyActivity Game::getEnemyActivity(const Enemy& enemy) const {
+    if (EnemyTraits<Type>::chases) return ENEMY_ACTIVE;
+    int reachLeft = enemy.rect.x - (enemy.pendingTicks + 1) * (fixedToInt(EnemyTraits<Type>::speed) + 1);
+    int activeRight = std::max(cameraX + SCREEN_WIDTH, playerRect.x + playerRect.w) + ENEMY_FULL_RATE_MARGIN;
+    if (reachLeft < activeRight) return ENEMY_ACTIVE;
+    if (reachLeft < activeRight + ENEMY_WAKE_MARGIN) return ENEMY_THROTTLED;
+    return ENEMY_ASLEEP;
+}
+
+bool Game::fallEnemy(Enemy& enemy, const std::vector<Tile>& solids) const {
+    int previousY = enemy.rect.y;
+    enemy.velocityY += GRAVITY;
+    enemy.positionY += enemy.velocityY;
+    enemy.rect.y = fixedToInt(enemy.positionY);
+
+    bool onGround = false;
+    for (const auto& tile : solids) {
+        if (checkCollision(enemy.rect, tile.rect)) {
+            if (enemy.velocityY > 0 && previousY + enemy.rect.h <= tile.rect.y) {
+                enemy.positionY = toFixed(tile.rect.y - enemy.rect.h);
+                enemy.velocityY = 0;
+                onGround = true;
+            } else if (enemy.velocityY < 0 && previousY >= tile.rect.y + tile.rect.h) {
+                enemy.positionY = toFixed(tile.rect.y + tile.rect.h);
+                enemy.velocityY = 0;
             }
+            enemy.rect.y = fixedToInt(enemy.positionY);
         }
     }
+    if (enemy.rect.y > SCREEN_HEIGHT) enemy.active = false;
+    return onGround;
 }
 
-void Game::cleanUpObjects() {
-    tiles.erase(std::remove_if(tiles.begin(), tiles.end(),
-        [this](const Tile& tile) { return tile.rect.x + tile.rect.w < cameraX; }), tiles.end());
-    bullets.erase(std::remove_if(bullets.begin(), bullets.end(),
-        [](const Bullet& b) { return !b.active; }), bullets.end());
-    enemyBullets.erase(std::remove_if(enemyBullets.begin(), enemyBullets.end(),
-        [](const Bullet& b) { return !b.active; }), enemyBullets.end());
-    enemies.erase(std::remove_if(enemies.begin(), enemies.end(),
-        [](const Enemy& e) { return !e.active; }), enemies.end());
+template <int Type>
+void Game::patrolEnemy(Enemy& enemy) const {
+    Fixed moveX = enemy.facingLeft ? -EnemyTraits<Type>::speed : EnemyTraits<Type>::speed;
+    SDL_Rect futureRect = enemy.rect;
+    futureRect.x = fixedToInt(enemy.positionX + moveX);
+
+    bool willCollide = terrain->overlaps(futureRect);
+    bool hasPlatformAhead = terrain->isSolidAt(enemy.facingLeft ? enemy.rect.x - 1 : enemy.rect.x + enemy.rect.w,
+                                              enemy.rect.y + enemy.rect.h);
+
+    if (willCollide || !hasPlatformAhead) {
+        enemy.facingLeft = !enemy.facingLeft;
+    } else {
+        enemy.positionX += moveX;
+        enemy.rect.x = fixedToInt(enemy.positionX);
+    }
 }
 
-void Game::loadBestScore() {
-    std::ifstream file("best_score.txt");
-    if (file.is_open()) { file >> bestScore; file.close(); }
+template <int Type>
+void Game::advanceRemoteEnemy(Enemy& enemy, const std::vector<Tile>& solids) const {
+    for (; enemy.pendingTicks > 0 && enemy.active; enemy.pendingTicks--) {
+        if (!fallEnemy(enemy, solids) || !enemy.active) continue;
+        patrolEnemy<Type>(enemy);
+        if (enemy.shootCooldown > 0) enemy.shootCooldown--;
+    }
+    enemy.pendingTicks = 0;
 }
 
-void Game::saveBestScore() {
-    std::ofstream file("best_score.txt");
-    if (file.is_open()) { file << bestScore; file.close(); }
+template <int Type>
+void Game::gatherEnemyTiles(const Enemy& enemy, std::vector<Tile>& solids) const {
+    int reach = enemy.pendingTicks * (fixedToInt(EnemyTraits<Type>::speed) + 1);
+    solids.clear();
+    for (const auto& tile : *tiles) {
+        if (tile.rect.x < enemy.rect.x + enemy.rect.w + reach && tile.rect.x + tile.rect.w > enemy.rect.x - reach) {
+            solids.push_back(tile);
+        }
+    }
+}
+
+template <int Type>
+void Game::catchUpEnemy(Enemy& enemy) {
+    if (enemy.pendingTicks == 0) return;
+    gatherEnemyTiles<Type>(enemy, enemyTiles);
+    advanceRemoteEnemy<Type>(enemy, enemyTiles);
+}
+
+void Game::catchUpEnemies() {
+    forEachEnemyType([this](auto type) {
+        constexpr int Type = decltype(type)::value;
+        for (auto& enemy : enemies[Type]) {
+            if (enemy.active) this->template catchUpEnemy<Type>(enemy);
+        }
+    });
+}
+
+void Game::addTile(const SDL_Rect& rect, bool isGround) {
+    tiles.edit().push_back({rect, isGround});
+    terrain.edit().addTile(rect);
+    projectiles.addTile(rect);
+}
+
+void Game::cleanUpObjects() {
+    PROFILE_ZONE("Game::cleanUpObjects");
+    auto offscreen = [this](const Tile& tile) { return tile.rect.x + tile.rect.w < cameraX; };
+    if (std::any_of(tiles->begin(), tiles->end(), offscreen)) {
+        std::vector<Tile>& liveTiles = tiles.edit();
+        liveTiles.erase(std::remove_if(liveTiles.begin(), liveTiles.end(), offscreen), liveTiles.end());
+        terrain.edit().evictBefore(cameraX);
+        navGraph.edit().evictBefore(cameraX);
+    }
+    projectiles.removeInactive();
+    for (auto& bucket : enemies) {
+        bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+            [](const Enemy& e) { return !e.active; }), bucket.end());
+    }
+}
+
+void Game::endRun(DeathCause cause) {
+    RunRecord record = {runSeed, score, static_cast<Uint32>(simulationTick), static_cast<Sint32>(maxPlayerX), cause, 0};
+    if (replayMode == REPLAY_OFF && !simulationOnly && !net.isActive()) {
+        runHistory.submit(record);
+        runHistory.writeFileAsync(LAST_REPLAY_PATH, replay.serialize());
+    }
+    bestScore = std::max(bestScore, score);
+    gameState = GAME_OVER;
 }
 
 void Game::updateMusic() {
     if (gameState == MAIN_MENU || gameState == INSTRUCTIONS || gameState == RECORDS || gameState == OPTIONS) {
-        if (musicOn && !Mix_PlayingMusic()) Mix_PlayMusic(menuMusic, -1);
-        else if (!musicOn && Mix_PlayingMusic()) Mix_HaltMusic();
+        if (musicOn && !audio.isMusicPlaying()) audio.playMusic(menuMusic.get());
+        else if (!musicOn && audio.isMusicPlaying()) audio.haltMusic();
     } else if (gameState == PLAYING) {
-        if (musicOn && !Mix_PlayingMusic()) Mix_PlayMusic(inGameMusic, -1);
-        else if (!musicOn && Mix_PlayingMusic()) Mix_HaltMusic();
-    } else if (gameState == GAME_OVER) Mix_HaltMusic();
+        if (musicOn && !audio.isMusicPlaying()) audio.playMusic(inGameMusic.get());
+        else if (!musicOn && audio.isMusicPlaying()) audio.haltMusic();
+    } else if (gameState == GAME_OVER) audio.haltMusic();
 }
 
 void Game::playSFX(Mix_Chunk* sound) {
-    if (sfxOn) Mix_PlayChannel(-1, sound, 0);
+    if (seeking || simulationOnly) return;
+    if (sfxOn) audio.playSound(sound);
+}
+
+void Game::emitParticles(const SDL_Rect& rect, ParticleEffect effect, bool facingLeft) {
+    if (seeking || simulationOnly) return;
+    particles.emit(rect.x + rect.w / 2.0f, rect.y + rect.h / 2.0f, effect, facingLeft);
 }
 
 void Game::close() {
-    SDL_DestroyTexture(playerTexture);
-    SDL_DestroyTexture(groundTexture);
-    SDL_DestroyTexture(floatingTexture);
-    SDL_DestroyTexture(enemy1Texture);
-    SDL_DestroyTexture(enemy2Texture);
-    SDL_DestroyTexture(enemy3Texture);
-    SDL_DestroyTexture(enemy4Texture);
-    SDL_DestroyTexture(enemy5Texture);
-    SDL_DestroyTexture(bulletTexture);
-    SDL_DestroyTexture(enemyBulletTexture);
-    SDL_DestroyTexture(backgroundTexture);
-    SDL_DestroyTexture(spikeTexture);
-    for (auto texture : heartTextures) SDL_DestroyTexture(texture);
-    TTF_CloseFont(font);
-    TTF_CloseFont(titleFont);
-    TTF_CloseFont(scoreFont);
+    if (simulationOnly) return;
+    resources.printStats();
+    for (auto& sprite : sprites) sprite.reset();
+    renderScaler.destroy();
+    textCache.destroy();
+    for (auto& font : fonts) font.reset();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
-    Mix_FreeChunk(hitSound);
-    Mix_FreeChunk(shootSound);
-    Mix_FreeChunk(boomSound);
-    Mix_FreeChunk(jumpSound);
-    Mix_FreeMusic(inGameMusic);
-    Mix_FreeMusic(menuMusic);
-    Mix_CloseAudio();
+    if (frameSurface) SDL_FreeSurface(frameSurface);
+    frameSurface = nullptr;
+    hitSound.reset();
+    shootSound.reset();
+    boomSound.reset();
+    jumpSound.reset();
+    inGameMusic.reset();
+    menuMusic.reset();
+    resources.destroy();
+    runHistory.shutdown();
+    audio.printStats();
+    framePacer.printStats();
+    net.close();
+    audio.close();
     IMG_Quit();
     TTF_Quit();
     SDL_Quit();
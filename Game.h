@@ -5,101 +5,222 @@
 #include <SDL_mixer.h>
 #include <vector>
 #include <random>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include "Config.h"
 #include "Structs.h"
+#include "AudioManager.h"
+#include "CollisionMask.h"
+#include "RenderList.h"
+#include "RenderScaler.h"
+#include "ResourceManager.h"
+#include "FramePacer.h"
+#include "ParticleSystem.h"
+#include "ProjectileSystem.h"
+#include "TextCache.h"
+#include "FrameArena.h"
+#include "RunHistory.h"
+#include "Replay.h"
+#include "TerrainProfile.h"
+#include "NavGraph.h"
+#include "Reachability.h"
+#include "EnemyTraits.h"
+#include "GameSnapshot.h"
+#include "RollbackSession.h"
 
 class Game {
 public:
-    Game();
+    explicit Game(bool simulationOnly = false);
     ~Game();
-    bool init();
+    bool init(bool headless = false);
+    void setFrameRate(int rate) { frameRate = rate; }
+    void setThreadedRendering(bool enabled) { threadedRendering = enabled; }
     void run();
     void close();
-    TTF_Font* scoreFont;
+    bool startReplay(const char* path, ReplayMode mode, int seekTick);
+    bool startNetPlay(const char* hostName, Uint16 port, int delayMs, int jitterMs, int lossPercent);
+    int runRenderBenchmark(const char* replayPath, const char* goldenDir, bool updateGolden);
+    int runPerfBenchmark(const char* replayPath, bool renderFrames, const char* baselinePath, bool updateBaseline);
+    static int runReachabilityBatch(Uint32 firstSeed, int seedCount, int chunksPerSeed);
+    static int runSelfChecks();
+    void reset(Uint32 seed);
+    void step(Uint8 input);
+    void observe(EnvObservation& observation) const;
+    bool isRunOver() const { return gameState != PLAYING; }
+    int getScore() const { return score; }
+    int getLives() const { return lives; }
+    void setEnemySpriteSize(int type, int width, int height);
+    void loadCollisionMasks();
+    void copyCollisionMasks(const Game& other);
+    bool hasLineOfSight(const SDL_Rect& from, const SDL_Rect& to) const;
+    void snapshot(GameSnapshot& state) const;
+    void restore(const GameSnapshot& state);
 
 private:
+    static bool checkSecondRunReplay();
+    static bool checkNetPeersAgree();
+    static bool checkPitChunkPatched();
+    void playScriptedRun(int ticks);
+    void runSerial();
+    void runThreaded();
+    void simulationLoop();
+    bool isSimulating() const;
+    bool isFrameDue(bool simulating) const;
+    int idleTimeout() const;
+    bool advanceFrame();
+    void requestQuit(int code);
+    void wakeRenderer();
+    void forwardEvents();
+    void handleQueuedEvents();
     void handleEvents();
+    void handleEvent(const SDL_Event& e);
+    static Uint8 readKeyboard();
+    Uint8 pollInput();
+    void applyInput(Uint8 input);
+    void simulateTick();
+    void simulateNetTick();
+    void advanceNetFrame();
+    void seekReplay(int targetTick);
+    void fastForwardReplay(int targetTick);
+    void finishReplay();
+    Uint32 stateChecksum() const;
+    int randomInt(int n);
+    bool chance(int perMille);
+    void handleWindowEvent(const SDL_WindowEvent& event);
+    void setPaused(bool pause);
     void update();
     void render();
+    void layoutMenuButtons();
+    bool isButtonHit(size_t index, int x, int y) const;
+    void buildRenderList(RenderList& list);
+    void submitRenderList(const RenderList& list);
+    void draw(SDL_Texture* texture, const SDL_Rect* dest, SDL_RendererFlip flip = SDL_FLIP_NONE);
     void renderText(const char* text, int x, int y, SDL_Color color, TTF_Font* font, bool center = false);
     void generateWorld();
+    int chunkExitY() const;
+    void validateChunk(int chunkLeft);
+    void addTile(const SDL_Rect& rect, bool isGround);
     void resetGame();
+    void resetGame(Uint32 seed);
     void fireBullet();
     void spawnEnemy(int x, int y);
     bool canSpawnEnemy(int x, int y, int width, int height);
+    int enemyWidth(int type) const;
     void updateEnemies();
+    template <int Type> void updateEnemyBucket(Fixed enemyBulletSpeed);
+    void syncPlayerRect();
+    template <int Type> EnemyActivity getEnemyActivity(const Enemy& enemy) const;
+    bool fallEnemy(Enemy& enemy, const std::vector<Tile>& solids) const;
+    template <int Type> void patrolEnemy(Enemy& enemy) const;
+    template <int Type> void advanceRemoteEnemy(Enemy& enemy, const std::vector<Tile>& solids) const;
+    template <int Type> void gatherEnemyTiles(const Enemy& enemy, std::vector<Tile>& solids) const;
+    template <int Type> void catchUpEnemy(Enemy& enemy);
+    void catchUpEnemies();
+    bool canSeePlayer(Enemy& enemy);
+    const NavEdge* planChase(Enemy& enemy);
     void cleanUpObjects();
-    void loadBestScore();
-    void saveBestScore();
+    void endRun(DeathCause cause);
     void updateMusic();
     void playSFX(Mix_Chunk* sound);
+    void emitParticles(const SDL_Rect& rect, ParticleEffect effect, bool facingLeft = false);
     bool isSpacePressed;
-    float baseSpawnThreshold = 0.9f;
-    float spawnThresholdDecrease = 0.03f;
-    float currentSpawnThreshold;
-    float baseBulletSpeed = 10.0f;
-    float baseEnemyBulletSpeed = 3.0f;
-    float bulletSpeedIncrease = 0.5f;
+    int baseSpawnThreshold = 900;
+    int spawnThresholdDecrease = 30;
+    int currentSpawnThreshold;
     int lastDifficultyThreshold = 0;
     int getNextDifficultyThreshold(int currentScore);
+    bool simulationOnly;
     SDL_Window* window;
     SDL_Renderer* renderer;
-    TTF_Font* font;
-    TTF_Font* titleFont;
-    SDL_Texture* playerTexture;
-    SDL_Texture* groundTexture;
-    SDL_Texture* floatingTexture;
-    SDL_Texture* enemy1Texture;
-    SDL_Texture* enemy2Texture;
-    SDL_Texture* enemy3Texture;
-    SDL_Texture* enemy4Texture;
-    SDL_Texture* enemy5Texture;
-    SDL_Texture* bulletTexture;
-    SDL_Texture* enemyBulletTexture;
-    SDL_Texture* backgroundTexture;
-    SDL_Texture* spikeTexture;
-    std::vector<SDL_Texture*> heartTextures;
-    Mix_Chunk* hitSound;
-    Mix_Chunk* shootSound;
-    Mix_Chunk* boomSound;
-    Mix_Chunk* jumpSound;
-    Mix_Music* inGameMusic;
-    Mix_Music* menuMusic;
+    SDL_Surface* frameSurface;
+    int drawCalls;
+    ResourceManager resources;
+    FontHandle fonts[FONT_COUNT];
+    TextureHandle sprites[SPRITE_COUNT];
+    CollisionMask spriteMasks[SPRITE_COUNT];
+    SoundHandle hitSound;
+    SoundHandle shootSound;
+    SoundHandle boomSound;
+    SoundHandle jumpSound;
+    MusicHandle inGameMusic;
+    MusicHandle menuMusic;
 
-    float enemy4AspectRatio;
-    float enemy5AspectRatio;
+    int enemyWidths[ENEMY_TYPE_COUNT];
 
     GameState gameState;
+    GameState renderedState;
+    bool needsRedraw;
+    bool paused;
+    bool hasFocus;
+    bool isMinimized;
     bool isJumping;
     bool isOnGround;
     bool playerFlipped;
-    float playerVelX;
-    float playerVelY;
+    Fixed playerPosX;
+    Fixed playerPosY;
+    Fixed playerVelX;
+    Fixed playerVelY;
     int score;
     int bestScore;
-    float cameraX;
-    float maxPlayerX;
+    int cameraX;
+    int maxPlayerX;
     int shootCooldown;
     int groundHeight;
     int lastGeneratedX;
     int lives;
-    Uint32 invincibilityTimer;
+    int simulationTick;
+    Uint32 runSeed;
+    RunHistory runHistory;
+    int invincibilityTimer;
     bool isInvincible;
     bool musicOn;
     bool sfxOn;
+    AudioManager audio;
+    RenderScaler renderScaler;
+    RenderScaleMode renderScale;
+    RenderBuffer renderBuffer;
+    bool threadedRendering;
+    bool simulationThreaded;
+    std::atomic<bool> quitRequested;
+    int exitCode;
+    std::atomic<Uint8> heldInput;
+    Uint32 wakeEventType;
+    std::mutex eventMutex;
+    std::condition_variable eventReady;
+    std::vector<SDL_Event> pendingEvents;
+    std::vector<SDL_Event> queuedEvents;
+    ParticleSystem particles;
+    TextCache textCache;
+    FrameArena frameArena;
+    FramePacer framePacer;
+    int frameRate;
+    Replay replay;
+    ReplayMode replayMode;
+    std::vector<GameSnapshot> keyframes;
+    GameSnapshot checkpoint;
+    bool hasCheckpoint;
+    RollbackSession net;
+    std::vector<GameSnapshot> netStates;
+    int replayDesyncTick;
+    bool spaceTapped;
+    bool seeking;
+    bool showSightLines;
 
     SDL_Rect playerRect;
-    std::vector<Tile> tiles;
-    std::vector<Bullet> bullets;
-    std::vector<Bullet> enemyBullets;
-    std::vector<Enemy> enemies;
+    CopyOnWrite<std::vector<Tile>> tiles;
+    std::vector<Tile> enemyTiles;
+    ProjectileSystem projectiles;
+    EnemyBuckets enemies;
     std::vector<SDL_Rect> spikes;
     std::vector<Button> menuButtons;
+    CopyOnWrite<TerrainProfile> terrain;
+    CopyOnWrite<NavGraph> navGraph;
+    NavField navField;
+    ReachabilityValidator reachability;
+    ReachabilityStats reachStats;
 
     std::mt19937 gen;
-    std::uniform_int_distribution<> yDist;
-    std::uniform_int_distribution<> gapDist;
-    std::uniform_real_distribution<> spawnDist;
 };
 
 #endif
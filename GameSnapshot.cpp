@@ -0,0 +1,104 @@
+#include "GameSnapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <type_traits>
+
+static const Uint32 SNAPSHOT_MAGIC = 0x504E5355;
+static const Uint32 SNAPSHOT_VERSION = 5;
+
+static_assert(std::is_trivially_copyable<SnapshotCore>::value, "SnapshotCore must stay POD");
+static_assert(std::is_trivially_copyable<Tile>::value, "Tile must stay POD");
+static_assert(std::is_trivially_copyable<Projectile>::value, "Projectile must stay POD");
+static_assert(std::is_trivially_copyable<Enemy>::value, "Enemy must stay POD");
+
+static void appendBytes(std::vector<Uint8>& bytes, const void* data, size_t size) {
+    const Uint8* begin = static_cast<const Uint8*>(data);
+    bytes.insert(bytes.end(), begin, begin + size);
+}
+
+template <typename T>
+static void appendValue(std::vector<Uint8>& bytes, const T& value) {
+    appendBytes(bytes, &value, sizeof(T));
+}
+
+template <typename T>
+static void appendVector(std::vector<Uint8>& bytes, const std::vector<T>& values) {
+    appendValue(bytes, static_cast<Uint32>(values.size()));
+    if (!values.empty()) appendBytes(bytes, values.data(), values.size() * sizeof(T));
+}
+
+struct SnapshotReader {
+    const std::vector<Uint8>& bytes;
+    size_t offset;
+
+    bool read(void* data, size_t size) {
+        if (size > bytes.size() - offset) return false;
+        if (size) memcpy(data, bytes.data() + offset, size);
+        offset += size;
+        return true;
+    }
+
+    template <typename T>
+    bool readValue(T& value) {
+        return read(&value, sizeof(T));
+    }
+
+    template <typename T>
+    bool readVector(std::vector<T>& values) {
+        Uint32 count;
+        if (!readValue(count) || count > (bytes.size() - offset) / sizeof(T)) return false;
+        values.resize(count);
+        return read(values.data(), count * sizeof(T));
+    }
+};
+
+std::vector<Uint8> GameSnapshot::serialize() const {
+    std::vector<Uint8> bytes;
+    appendValue(bytes, SNAPSHOT_MAGIC);
+    appendValue(bytes, SNAPSHOT_VERSION);
+    appendValue(bytes, core);
+    appendVector(bytes, *tiles);
+    appendVector(bytes, projectiles);
+    for (const auto& bucket : enemies) appendVector(bytes, bucket);
+    appendVector(bytes, spikes);
+    std::ostringstream rngState;
+    rngState << gen;
+    std::string rngText = rngState.str();
+    appendVector(bytes, std::vector<char>(rngText.begin(), rngText.end()));
+    return bytes;
+}
+
+bool GameSnapshot::deserialize(const std::vector<Uint8>& bytes) {
+    SnapshotReader reader = {bytes, 0};
+    Uint32 magic, version;
+    if (!reader.readValue(magic) || !reader.readValue(version) || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+        printf("Snapshot has an unknown format\n");
+        return false;
+    }
+    SnapshotCore loadedCore;
+    std::vector<Tile> loadedTiles;
+    std::vector<char> rngText;
+    bool ok = reader.readValue(loadedCore) && reader.readVector(loadedTiles) &&
+              reader.readVector(projectiles);
+    for (auto& bucket : enemies) ok = ok && reader.readVector(bucket);
+    ok = ok && reader.readVector(spikes) && reader.readVector(rngText);
+    if (!ok) {
+        printf("Snapshot is truncated\n");
+        return false;
+    }
+    std::istringstream rngState(std::string(rngText.begin(), rngText.end()));
+    rngState >> gen;
+    core = loadedCore;
+    tiles.edit().swap(loadedTiles);
+    terrain.edit().rebuild(*tiles);
+    int left = tiles->empty() ? 0 : tiles->front().rect.x;
+    int right = left;
+    for (const auto& tile : *tiles) {
+        left = std::min(left, tile.rect.x);
+        right = std::max(right, tile.rect.x + tile.rect.w);
+    }
+    navGraph.edit().rebuild(*terrain, left, right);
+    return true;
+}
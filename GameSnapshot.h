@@ -0,0 +1,52 @@
+#ifndef GAME_SNAPSHOT_H
+#define GAME_SNAPSHOT_H
+#include <SDL.h>
+#include <vector>
+#include <random>
+#include "Structs.h"
+#include "TerrainProfile.h"
+#include "NavGraph.h"
+#include "EnemyTraits.h"
+#include "CopyOnWrite.h"
+
+struct SnapshotCore {
+    int tick;
+    Uint32 runSeed;
+    bool isJumping;
+    bool isOnGround;
+    bool isSpacePressed;
+    bool playerFlipped;
+    bool isInvincible;
+    bool runOver;
+    Fixed playerPosX;
+    Fixed playerPosY;
+    Fixed playerVelX;
+    Fixed playerVelY;
+    int score;
+    int cameraX;
+    int maxPlayerX;
+    int shootCooldown;
+    int groundHeight;
+    int lastGeneratedX;
+    int lives;
+    int invincibilityTimer;
+    int lastDifficultyThreshold;
+    int currentSpawnThreshold;
+    SDL_Rect playerRect;
+};
+
+struct GameSnapshot {
+    SnapshotCore core;
+    CopyOnWrite<std::vector<Tile>> tiles;
+    CopyOnWrite<TerrainProfile> terrain;
+    CopyOnWrite<NavGraph> navGraph;
+    std::vector<Projectile> projectiles;
+    EnemyBuckets enemies;
+    std::vector<SDL_Rect> spikes;
+    std::mt19937 gen;
+
+    std::vector<Uint8> serialize() const;
+    bool deserialize(const std::vector<Uint8>& bytes);
+};
+
+#endif
@@ -0,0 +1,228 @@
+#include "NavGraph.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <functional>
+
+static int airTicks(Fixed velocityY, int rise) {
+    Fixed y = 0;
+    int previous = 0;
+    for (int tick = 1; tick <= NAV_MAX_AIR_TICKS; tick++) {
+        velocityY += GRAVITY;
+        y += velocityY;
+        int feet = fixedToInt(y);
+        if (velocityY > 0 && previous > rise) return -1;
+        if (velocityY > 0 && feet >= rise) return tick;
+        previous = feet;
+    }
+    return -1;
+}
+
+NavGraph::NavGraph() : firstSlot(0), nodeCount(0), firstId(0), version(0) {
+}
+
+void NavGraph::clear() {
+    for (auto& navNode : nodes) {
+        navNode.edges.clear();
+        navNode.incoming.clear();
+    }
+    firstSlot = 0;
+    nodeCount = 0;
+    firstId = 0;
+    version++;
+}
+
+void NavGraph::rebuild(const TerrainProfile& terrain, int left, int right) {
+    clear();
+    addChunk(terrain, left, right);
+}
+
+NavNode& NavGraph::slot(int offset) {
+    return nodes[(firstSlot + offset) % nodes.size()];
+}
+
+void NavGraph::grow() {
+    std::vector<NavNode> grown(std::max<size_t>(nodes.size() * 2, NAV_RESERVE_NODES));
+    for (int i = 0; i < nodeCount; i++) std::swap(grown[i], slot(i));
+    nodes.swap(grown);
+    firstSlot = 0;
+}
+
+const NavNode* NavGraph::node(int id) const {
+    int offset = id - firstId;
+    if (offset < 0 || offset >= nodeCount) return nullptr;
+    return &nodes[(firstSlot + offset) % nodes.size()];
+}
+
+void NavGraph::addChunk(const TerrainProfile& terrain, int left, int right) {
+    terrain.findSurfaces(left, right, NAV_CLEARANCE, surfaces);
+    if (surfaces.empty()) return;
+    std::sort(surfaces.begin(), surfaces.end(), [](const TerrainSpan& a, const TerrainSpan& b) {
+        return a.left != b.left ? a.left < b.left : a.top < b.top;
+    });
+    int newFirst = firstId + nodeCount;
+    for (const auto& surface : surfaces) {
+        if (nodeCount == static_cast<int>(nodes.size())) grow();
+        int maxRight = nodeCount > 0 ? std::max(slot(nodeCount - 1).maxRight, surface.right) : surface.right;
+        NavNode& added = slot(nodeCount++);
+        added.left = surface.left;
+        added.right = surface.right;
+        added.y = surface.top;
+        added.maxRight = maxRight;
+        added.edges.clear();
+        added.incoming.clear();
+    }
+    int end = firstId + nodeCount;
+    for (int id = newFirst; id < end; id++) {
+        int reachLeft = node(id)->left - NAV_MAX_REACH;
+        for (int other = end - 1; other >= firstId && node(other)->maxRight >= reachLeft; other--) {
+            if (other == id) continue;
+            link(id, other);
+            if (other < newFirst) link(other, id);
+        }
+    }
+    version++;
+}
+
+void NavGraph::evictBefore(int x) {
+    while (nodeCount > 0 && slot(0).right < x) {
+        firstSlot = (firstSlot + 1) % nodes.size();
+        nodeCount--;
+        firstId++;
+        version++;
+    }
+}
+
+int NavGraph::findNode(int left, int right, int feetY, int maxDrop) const {
+    int found = -1;
+    int foundY = 0;
+    for (int i = 0; i < nodeCount; i++) {
+        const NavNode& candidate = nodes[(firstSlot + i) % nodes.size()];
+        if (candidate.right <= left || candidate.left >= right || candidate.y < feetY || candidate.y > feetY + maxDrop) continue;
+        if (found < 0 || candidate.y < foundY) {
+            found = firstId + i;
+            foundY = candidate.y;
+        }
+    }
+    return found;
+}
+
+void NavGraph::addEdge(int fromId, const NavEdge& edge) {
+    slot(fromId - firstId).edges.push_back(edge);
+    NavEdge reverse = edge;
+    reverse.node = fromId;
+    slot(edge.node - firstId).incoming.push_back(reverse);
+}
+
+bool NavGraph::flies(const NavNode& to, int startX, int direction, Fixed velocityY, Fixed airSpeed, int rise) const {
+    Fixed y = 0;
+    Fixed x = 0;
+    int previous = 0;
+    for (int tick = 0; tick < NAV_MAX_AIR_TICKS; tick++) {
+        velocityY += GRAVITY;
+        y += velocityY;
+        x += airSpeed;
+        int feet = fixedToInt(y);
+        int center = startX + direction * fixedToInt(x);
+        if (velocityY > 0 && previous > rise) return false;
+        if (velocityY > 0 && feet >= rise) return center >= to.left && center < to.right;
+        if (feet > rise && feet - NAV_CLEARANCE < rise + TILE_SIZE &&
+            center >= to.left - NAV_BODY_HALF && center < to.right + NAV_BODY_HALF) {
+            return false;
+        }
+        previous = feet;
+    }
+    return false;
+}
+
+void NavGraph::link(int fromId, int toId) {
+    const NavNode& from = *node(fromId);
+    const NavNode& to = *node(toId);
+    if (to.left - from.right > NAV_MAX_REACH || from.left - to.right > NAV_MAX_REACH) return;
+    int fromCenter = (from.left + from.right) / 2;
+    int toCenter = (to.left + to.right) / 2;
+    Sint8 direction = toCenter >= fromCenter ? 1 : -1;
+    int distance = std::abs(toCenter - fromCenter);
+    int edgeX = direction > 0 ? from.right : from.left;
+    if (to.y == from.y && to.left <= from.right && from.left <= to.right) {
+        addEdge(fromId, {toId, edgeX, distance, 0, direction, NAV_WALK});
+        return;
+    }
+
+    int rise = to.y - from.y;
+    for (int step = 1; rise > 0 && step <= NAV_AIR_SPEED_STEPS; step++) {
+        Fixed airSpeed = NAV_AIR_SPEED_STEP * step;
+        if (flies(to, edgeX + direction * NAV_BODY_HALF, direction, 0, airSpeed, rise)) {
+            addEdge(fromId, {toId, edgeX, distance + NAV_DROP_COST, airSpeed, direction, NAV_DROP});
+            return;
+        }
+    }
+    int ticks = airTicks(JUMP_FORCE, rise);
+    for (int step = 1; ticks > 0 && step <= NAV_AIR_SPEED_STEPS; step++) {
+        Fixed airSpeed = NAV_AIR_SPEED_STEP * step;
+        int offset = fixedToInt(airSpeed * ticks);
+        int landing = direction > 0 ? to.left + NAV_BODY_HALF : to.right - NAV_BODY_HALF;
+        int takeoff = std::max(from.left, std::min(from.right, landing - direction * offset));
+        if (flies(to, takeoff, direction, JUMP_FORCE, airSpeed, rise)) {
+            addEdge(fromId, {toId, takeoff, distance + NAV_JUMP_COST, airSpeed, direction, NAV_JUMP});
+            return;
+        }
+    }
+}
+
+NavField::NavField() : baseId(0), target(-1), version(0), valid(false) {
+}
+
+void NavField::update(const NavGraph& graph, int targetNode) {
+    if (valid && targetNode == target && graph.getVersion() == version) return;
+    valid = true;
+    target = targetNode;
+    version = graph.getVersion();
+    baseId = graph.getFirstId();
+    distances.assign(graph.getNodeCount(), INT_MAX);
+    if (!graph.node(target)) return;
+
+    typedef std::pair<int, int> Entry;
+    heap.clear();
+    distances[target - baseId] = 0;
+    heap.push_back({0, target});
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+        Entry entry = heap.back();
+        heap.pop_back();
+        if (entry.first > distances[entry.second - baseId]) continue;
+        for (const auto& edge : graph.node(entry.second)->incoming) {
+            if (!graph.node(edge.node)) continue;
+            int distance = entry.first + edge.cost;
+            int& best = distances[edge.node - baseId];
+            if (distance < best) {
+                best = distance;
+                heap.push_back({distance, edge.node});
+                std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+            }
+        }
+    }
+}
+
+int NavField::distanceTo(int nodeId) const {
+    int offset = nodeId - baseId;
+    if (offset < 0 || offset >= static_cast<int>(distances.size())) return INT_MAX;
+    return distances[offset];
+}
+
+int NavField::bestEdge(const NavGraph& graph, int nodeId) const {
+    const NavNode* from = graph.node(nodeId);
+    if (!valid || !from || nodeId == target) return -1;
+    int best = -1;
+    int bestCost = INT_MAX;
+    for (size_t i = 0; i < from->edges.size(); i++) {
+        int remaining = distanceTo(from->edges[i].node);
+        if (remaining == INT_MAX) continue;
+        int cost = from->edges[i].cost + remaining;
+        if (cost < bestCost) {
+            best = static_cast<int>(i);
+            bestCost = cost;
+        }
+    }
+    return best;
+}
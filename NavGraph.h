@@ -0,0 +1,74 @@
+#ifndef NAV_GRAPH_H
+#define NAV_GRAPH_H
+#include <SDL.h>
+#include <vector>
+#include <utility>
+#include "Config.h"
+#include "TerrainProfile.h"
+
+enum NavEdgeType { NAV_WALK, NAV_DROP, NAV_JUMP };
+
+struct NavEdge {
+    int node;
+    int takeoffX;
+    int cost;
+    Fixed airSpeed;
+    Sint8 direction;
+    Uint8 type;
+};
+
+struct NavNode {
+    int left;
+    int right;
+    int y;
+    int maxRight;
+    std::vector<NavEdge> edges;
+    std::vector<NavEdge> incoming;
+};
+
+class NavGraph {
+public:
+    NavGraph();
+    void clear();
+    void rebuild(const TerrainProfile& terrain, int left, int right);
+    void addChunk(const TerrainProfile& terrain, int left, int right);
+    void evictBefore(int x);
+    int findNode(int left, int right, int feetY, int maxDrop) const;
+    const NavNode* node(int id) const;
+    int getFirstId() const { return firstId; }
+    int getNodeCount() const { return nodeCount; }
+    Uint32 getVersion() const { return version; }
+private:
+    NavNode& slot(int offset);
+    void grow();
+    void link(int fromId, int toId);
+    void addEdge(int fromId, const NavEdge& edge);
+    bool flies(const NavNode& to, int startX, int direction, Fixed velocityY, Fixed airSpeed, int rise) const;
+
+    std::vector<NavNode> nodes;
+    std::vector<TerrainSpan> surfaces;
+    int firstSlot;
+    int nodeCount;
+    int firstId;
+    Uint32 version;
+};
+
+class NavField {
+public:
+    NavField();
+    void invalidate() { valid = false; }
+    void update(const NavGraph& graph, int targetNode);
+    int bestEdge(const NavGraph& graph, int nodeId) const;
+    int getTarget() const { return target; }
+private:
+    int distanceTo(int nodeId) const;
+
+    std::vector<int> distances;
+    std::vector<std::pair<int, int>> heap;
+    int baseId;
+    int target;
+    Uint32 version;
+    bool valid;
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include "NetSocket.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static const uintptr_t INVALID_HANDLE = ~static_cast<uintptr_t>(0);
+
+static void closeHandle(uintptr_t handle) {
+#ifdef _WIN32
+    closesocket(static_cast<SOCKET>(handle));
+#else
+    ::close(static_cast<int>(handle));
+#endif
+}
+
+NetSocket::NetSocket() :
+    handle(INVALID_HANDLE), opened(false), delayMs(0), jitterMs(0), lossPercent(0), rng(std::random_device()()) {
+}
+
+NetSocket::~NetSocket() {
+    close();
+}
+
+bool NetSocket::open(Uint16 port) {
+    close();
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        printf("WSAStartup failed\n");
+        return false;
+    }
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    bool created = s != INVALID_SOCKET;
+#else
+    int s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    bool created = s >= 0;
+#endif
+    if (!created) {
+        printf("Could not create UDP socket\n");
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+    handle = static_cast<uintptr_t>(s);
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    bool configured = bind(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+                      ioctlsocket(s, FIONBIO, &nonBlocking) == 0;
+#else
+    bool configured = bind(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+                      fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+    if (!configured) {
+        printf("Could not bind UDP port %d\n", port);
+        closeHandle(handle);
+        handle = INVALID_HANDLE;
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+    opened = true;
+    delayed.reserve(NET_MAX_DELAYED_PACKETS);
+    return true;
+}
+
+void NetSocket::close() {
+    if (!opened) return;
+    closeHandle(handle);
+    handle = INVALID_HANDLE;
+    opened = false;
+    delayed.clear();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool NetSocket::resolve(const char* hostName, Uint16 port, NetAddress& address) {
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(hostName, nullptr, &hints, &result) != 0 || !result) {
+        printf("Could not resolve host %s\n", hostName);
+        return false;
+    }
+    address.host = reinterpret_cast<sockaddr_in*>(result->ai_addr)->sin_addr.s_addr;
+    address.port = htons(port);
+    freeaddrinfo(result);
+    return true;
+}
+
+void NetSocket::setConditions(int delay, int jitter, int loss) {
+    delayMs = std::max(0, delay);
+    jitterMs = std::max(0, jitter);
+    lossPercent = std::max(0, std::min(100, loss));
+}
+
+void NetSocket::send(const NetAddress& to, const Uint8* data, int size) {
+    if (!opened || size > NET_MAX_PACKET) return;
+    if (lossPercent > 0 && static_cast<int>(rng() % 100) < lossPercent) return;
+    if (delayMs == 0 && jitterMs == 0) {
+        sendNow(to, data, size);
+        return;
+    }
+    if (delayed.size() >= NET_MAX_DELAYED_PACKETS) return;
+    int latency = delayMs;
+    if (jitterMs > 0) latency += static_cast<int>(rng() % (2 * jitterMs + 1)) - jitterMs;
+    delayed.emplace_back();
+    DelayedPacket& packet = delayed.back();
+    packet.releaseMs = SDL_GetTicks() + std::max(0, latency);
+    packet.to = to;
+    packet.size = size;
+    memcpy(packet.data, data, size);
+}
+
+void NetSocket::flush() {
+    Uint32 now = SDL_GetTicks();
+    size_t kept = 0;
+    for (size_t i = 0; i < delayed.size(); i++) {
+        if (static_cast<Sint32>(delayed[i].releaseMs - now) <= 0) sendNow(delayed[i].to, delayed[i].data, delayed[i].size);
+        else if (kept++ != i) delayed[kept - 1] = delayed[i];
+    }
+    delayed.resize(kept);
+}
+
+void NetSocket::sendNow(const NetAddress& to, const Uint8* data, int size) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = to.host;
+    address.sin_port = to.port;
+#ifdef _WIN32
+    sendto(static_cast<SOCKET>(handle), reinterpret_cast<const char*>(data), size, 0,
+           reinterpret_cast<sockaddr*>(&address), sizeof(address));
+#else
+    sendto(static_cast<int>(handle), data, size, 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+#endif
+}
+
+int NetSocket::receive(Uint8* data, int capacity, NetAddress& from) {
+    if (!opened) return 0;
+    sockaddr_in address;
+    socklen_t length = sizeof(address);
+#ifdef _WIN32
+    int size = recvfrom(static_cast<SOCKET>(handle), reinterpret_cast<char*>(data), capacity, 0,
+                        reinterpret_cast<sockaddr*>(&address), &length);
+#else
+    int size = static_cast<int>(recvfrom(static_cast<int>(handle), data, capacity, 0,
+                                         reinterpret_cast<sockaddr*>(&address), &length));
+#endif
+    if (size <= 0) return 0;
+    from.host = address.sin_addr.s_addr;
+    from.port = address.sin_port;
+    return size;
+}
@@ -0,0 +1,45 @@
+#ifndef NET_SOCKET_H
+#define NET_SOCKET_H
+#include <SDL.h>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include "Config.h"
+
+struct NetAddress {
+    Uint32 host;
+    Uint16 port;
+};
+
+struct DelayedPacket {
+    Uint32 releaseMs;
+    NetAddress to;
+    int size;
+    Uint8 data[NET_MAX_PACKET];
+};
+
+class NetSocket {
+public:
+    NetSocket();
+    ~NetSocket();
+    bool open(Uint16 port);
+    void close();
+    bool isOpen() const { return opened; }
+    static bool resolve(const char* hostName, Uint16 port, NetAddress& address);
+    void setConditions(int delayMs, int jitterMs, int lossPercent);
+    void send(const NetAddress& to, const Uint8* data, int size);
+    int receive(Uint8* data, int capacity, NetAddress& from);
+    void flush();
+private:
+    void sendNow(const NetAddress& to, const Uint8* data, int size);
+
+    uintptr_t handle;
+    bool opened;
+    int delayMs;
+    int jitterMs;
+    int lossPercent;
+    std::vector<DelayedPacket> delayed;
+    std::mt19937 rng;
+};
+
+#endif
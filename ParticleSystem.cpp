@@ -0,0 +1,146 @@
+#include "ParticleSystem.h"
+#include <cmath>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+struct ParticleEffectInfo {
+    int count;
+    float minSpeed;
+    float maxSpeed;
+    float spread;
+    int lifetime;
+    float size;
+    SDL_Color color;
+};
+
+const float PI = 3.14159265f;
+
+const ParticleEffectInfo PARTICLE_EFFECTS[] = {
+    {48, 1.0f, 6.0f, 2.0f * PI, 40, 4.0f, {255, 160, 40, 255}},
+    {16, 1.0f, 4.0f, 2.0f * PI, 24, 3.0f, {255, 60, 60, 255}},
+    {8, 2.0f, 6.0f, 0.5f, 8, 2.0f, {255, 240, 150, 255}}
+};
+}
+
+ParticleSystem::ParticleSystem() : capacity(0), count(0), rngState(1) {
+}
+
+void ParticleSystem::create(int particleCapacity) {
+    capacity = particleCapacity;
+    count = 0;
+    posX.assign(capacity, 0.0f);
+    posY.assign(capacity, 0.0f);
+    velX.assign(capacity, 0.0f);
+    velY.assign(capacity, 0.0f);
+    life.assign(capacity, 0.0f);
+    fade.assign(capacity, 0.0f);
+    size.assign(capacity, 0.0f);
+    colors.assign(capacity, SDL_Color{0, 0, 0, 0});
+    indices.resize(capacity * 6);
+    for (int i = 0; i < capacity; i++) {
+        int base = i * 4;
+        int* quad = &indices[i * 6];
+        quad[0] = base; quad[1] = base + 1; quad[2] = base + 2;
+        quad[3] = base + 2; quad[4] = base + 3; quad[5] = base;
+    }
+}
+
+void ParticleSystem::reset(Uint32 seed) {
+    count = 0;
+    rngState = seed ? seed : 1;
+}
+
+float ParticleSystem::random() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return (rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::emit(float x, float y, ParticleEffect effect, bool facingLeft) {
+    const ParticleEffectInfo& info = PARTICLE_EFFECTS[effect];
+    float direction = facingLeft ? PI : 0.0f;
+    for (int n = 0; n < info.count && count < capacity; n++, count++) {
+        float angle = direction + (random() - 0.5f) * info.spread;
+        float speed = info.minSpeed + random() * (info.maxSpeed - info.minSpeed);
+        float lifetime = info.lifetime * (0.5f + random() * 0.5f);
+        posX[count] = x;
+        posY[count] = y;
+        velX[count] = std::cos(angle) * speed;
+        velY[count] = std::sin(angle) * speed;
+        life[count] = lifetime;
+        fade[count] = 1.0f / lifetime;
+        size[count] = info.size;
+        colors[count] = info.color;
+    }
+}
+
+void ParticleSystem::update() {
+    float* x = posX.data();
+    float* y = posY.data();
+    float* vx = velX.data();
+    float* vy = velY.data();
+    float* remaining = life.data();
+    int i = 0;
+#ifdef __SSE2__
+    const __m128 drag = _mm_set1_ps(PARTICLE_DRAG);
+    const __m128 gravity = _mm_set1_ps(PARTICLE_GRAVITY);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 newVX = _mm_mul_ps(_mm_loadu_ps(vx + i), drag);
+        __m128 newVY = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vy + i), drag), gravity);
+        _mm_storeu_ps(vx + i, newVX);
+        _mm_storeu_ps(vy + i, newVY);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), newVX));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), newVY));
+        _mm_storeu_ps(remaining + i, _mm_sub_ps(_mm_loadu_ps(remaining + i), one));
+    }
+#endif
+    for (; i < count; i++) {
+        vx[i] *= PARTICLE_DRAG;
+        vy[i] = vy[i] * PARTICLE_DRAG + PARTICLE_GRAVITY;
+        x[i] += vx[i];
+        y[i] += vy[i];
+        remaining[i] -= 1.0f;
+    }
+    for (int j = count - 1; j >= 0; j--) {
+        if (remaining[j] <= 0.0f || y[j] > SCREEN_HEIGHT) kill(j);
+    }
+}
+
+void ParticleSystem::kill(int index) {
+    int last = --count;
+    posX[index] = posX[last];
+    posY[index] = posY[last];
+    velX[index] = velX[last];
+    velY[index] = velY[last];
+    life[index] = life[last];
+    fade[index] = fade[last];
+    size[index] = size[last];
+    colors[index] = colors[last];
+}
+
+int ParticleSystem::buildQuads(std::vector<SDL_Vertex>& vertices, int cameraX) const {
+    int visible = 0;
+    for (int i = 0; i < count; i++) {
+        float left = posX[i] - cameraX;
+        float half = size[i] * 0.5f;
+        if (left + half < 0 || left - half > SCREEN_WIDTH) continue;
+        SDL_Color color = colors[i];
+        float alpha = life[i] * fade[i];
+        color.a = static_cast<Uint8>(color.a * (alpha < 1.0f ? alpha : 1.0f));
+        vertices.push_back({{left - half, posY[i] - half}, color, {0, 0}});
+        vertices.push_back({{left + half, posY[i] - half}, color, {0, 0}});
+        vertices.push_back({{left + half, posY[i] + half}, color, {0, 0}});
+        vertices.push_back({{left - half, posY[i] + half}, color, {0, 0}});
+        visible++;
+    }
+    return visible;
+}
+
+void ParticleSystem::render(SDL_Renderer* renderer, const SDL_Vertex* quads, int quadCount) const {
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometry(renderer, nullptr, quads, quadCount * 4, indices.data(), quadCount * 6);
+}
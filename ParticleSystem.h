@@ -0,0 +1,35 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+#include <SDL.h>
+#include <vector>
+#include "Config.h"
+
+class ParticleSystem {
+public:
+    ParticleSystem();
+    void create(int capacity);
+    void reset(Uint32 seed);
+    void emit(float x, float y, ParticleEffect effect, bool facingLeft = false);
+    void update();
+    int buildQuads(std::vector<SDL_Vertex>& vertices, int cameraX) const;
+    void render(SDL_Renderer* renderer, const SDL_Vertex* quads, int quadCount) const;
+    int getCount() const { return count; }
+private:
+    float random();
+    void kill(int index);
+
+    int capacity;
+    int count;
+    Uint32 rngState;
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<float> life;
+    std::vector<float> fade;
+    std::vector<float> size;
+    std::vector<SDL_Color> colors;
+    std::vector<int> indices;
+};
+
+#endif
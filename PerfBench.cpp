@@ -0,0 +1,148 @@
+#include "PerfBench.h"
+#include <algorithm>
+#include <cstdio>
+
+PerfBench* PerfBench::active = nullptr;
+
+static const char* PERF_PHASE_NAMES[PERF_PHASE_COUNT] = {"update", "updateEnemies", "generateWorld", "resetGame", "render"};
+
+static Uint8 longRunInput(int tick) {
+    Uint8 input = INPUT_RIGHT;
+    if (tick % 40 < 12) input |= INPUT_JUMP;
+    if (tick % 30 == 0) input |= INPUT_FIRE;
+    return input;
+}
+
+static Uint8 firefightInput(int tick) {
+    Uint8 input = tick % 120 < 90 ? INPUT_RIGHT : INPUT_LEFT;
+    if (tick % 50 < 10) input |= INPUT_JUMP;
+    if (tick % 2 == 0) input |= INPUT_FIRE;
+    return input;
+}
+
+static Uint8 resetInput(int tick) {
+    Uint8 input = INPUT_RIGHT;
+    if (tick % 25 < 8) input |= INPUT_JUMP;
+    if (tick % 10 == 0) input |= INPUT_FIRE;
+    return input;
+}
+
+static const PerfSession PERF_SESSIONS[] = {
+    {"long-run", 101, 20000, 0, longRunInput},
+    {"firefight", 202, 6000, 0, firefightInput},
+    {"resets", 303, 6000, 120, resetInput}
+};
+
+PerfBench::PerfBench(const char* path, bool update) :
+    baselinePath(path), updateBaseline(update), tickCounters(), tickRan(),
+    microsPerCount(1000000.0 / SDL_GetPerformanceFrequency()) {
+    active = this;
+}
+
+PerfBench::~PerfBench() {
+    if (active == this) active = nullptr;
+}
+
+const PerfSession* PerfBench::sessions(int& count) {
+    count = static_cast<int>(sizeof(PERF_SESSIONS) / sizeof(PERF_SESSIONS[0]));
+    return PERF_SESSIONS;
+}
+
+void PerfBench::beginSession(const char* name, int ticks) {
+    sessionName = name;
+    for (auto& phaseSamples : samples) {
+        phaseSamples.clear();
+        phaseSamples.reserve(ticks);
+    }
+}
+
+void PerfBench::beginTick() {
+    for (int phase = 0; phase < PERF_PHASE_COUNT; phase++) {
+        tickCounters[phase] = 0;
+        tickRan[phase] = false;
+    }
+}
+
+void PerfBench::endTick() {
+    for (int phase = 0; phase < PERF_PHASE_COUNT; phase++) {
+        if (tickRan[phase]) samples[phase].push_back(tickCounters[phase] * microsPerCount);
+    }
+}
+
+void PerfBench::endSession() {
+    for (int phase = 0; phase < PERF_PHASE_COUNT; phase++) {
+        std::vector<double>& phaseSamples = samples[phase];
+        if (phaseSamples.empty()) continue;
+        std::sort(phaseSamples.begin(), phaseSamples.end());
+        size_t count = phaseSamples.size();
+        results.push_back({sessionName, phase, static_cast<int>(count), phaseSamples[count / 2], phaseSamples[count * 99 / 100]});
+    }
+}
+
+bool PerfBench::loadBaseline(std::vector<PerfResult>& baseline) const {
+    FILE* file = fopen(baselinePath.c_str(), "r");
+    if (!file) return false;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        char session[64], phase[64];
+        PerfResult entry;
+        if (sscanf(line, "%63[^,],%63[^,],%d,%lf,%lf", session, phase, &entry.samples, &entry.p50Us, &entry.p99Us) != 5) continue;
+        entry.session = session;
+        entry.phase = -1;
+        for (int i = 0; i < PERF_PHASE_COUNT; i++) {
+            if (std::string(phase) == PERF_PHASE_NAMES[i]) entry.phase = i;
+        }
+        if (entry.phase >= 0) baseline.push_back(entry);
+    }
+    fclose(file);
+    return true;
+}
+
+bool PerfBench::report() const {
+    if (updateBaseline) {
+        FILE* file = fopen(baselinePath.c_str(), "w");
+        if (!file) {
+            printf("Failed to write %s\n", baselinePath.c_str());
+            return false;
+        }
+        fprintf(file, "session,phase,samples,p50_us,p99_us\n");
+        for (const auto& result : results) {
+            fprintf(file, "%s,%s,%d,%.2f,%.2f\n", result.session.c_str(), PERF_PHASE_NAMES[result.phase],
+                    result.samples, result.p50Us, result.p99Us);
+        }
+        fclose(file);
+        printf("Wrote %d baseline entries to %s\n", static_cast<int>(results.size()), baselinePath.c_str());
+        return true;
+    }
+
+    std::vector<PerfResult> baseline;
+    if (!loadBaseline(baseline)) {
+        printf("Missing baseline %s (run with --update-baseline to create it)\n", baselinePath.c_str());
+        return false;
+    }
+    int failed = 0;
+    for (const auto& result : results) {
+        const PerfResult* expected = nullptr;
+        for (const auto& entry : baseline) {
+            if (entry.session == result.session && entry.phase == result.phase) expected = &entry;
+        }
+        const char* verdict = "(no baseline, FAILED)";
+        if (expected) {
+            // With fewer samples the p99 is just the single slowest tick, which is host noise rather than a regression.
+            bool gateP99 = result.samples >= PERF_MIN_P99_SAMPLES;
+            bool slower = result.p50Us > expected->p50Us * PERF_TOLERANCE + PERF_SLACK_US ||
+                          (gateP99 && result.p99Us > expected->p99Us * PERF_TOLERANCE + PERF_SLACK_US);
+            verdict = slower ? "(FAILED)" : "(ok)";
+            if (slower) failed++;
+        } else {
+            failed++;
+        }
+        printf("%-10s %-14s %6d samples  p50 %9.2f us  p99 %9.2f us", result.session.c_str(), PERF_PHASE_NAMES[result.phase],
+               result.samples, result.p50Us, result.p99Us);
+        if (expected) printf("  baseline %9.2f / %9.2f us", expected->p50Us, expected->p99Us);
+        printf("  %s\n", verdict);
+    }
+    printf("Performance budgets: %d of %d phases over budget or missing from the baseline\n", failed,
+           static_cast<int>(results.size()));
+    return failed == 0;
+}
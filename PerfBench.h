@@ -0,0 +1,64 @@
+#ifndef PERF_BENCH_H
+#define PERF_BENCH_H
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include "Config.h"
+
+enum PerfPhase { PERF_UPDATE, PERF_ENEMIES, PERF_WORLDGEN, PERF_RESET, PERF_RENDER, PERF_PHASE_COUNT };
+
+struct PerfSession {
+    const char* name;
+    Uint32 seed;
+    int ticks;
+    int resetInterval;
+    Uint8 (*input)(int tick);
+};
+
+struct PerfResult {
+    std::string session;
+    int phase;
+    int samples;
+    double p50Us;
+    double p99Us;
+};
+
+class PerfBench {
+public:
+    PerfBench(const char* baselinePath, bool updateBaseline);
+    ~PerfBench();
+    static PerfBench* active;
+    static const PerfSession* sessions(int& count);
+    void beginSession(const char* name, int ticks);
+    void beginTick();
+    void add(PerfPhase phase, Uint64 elapsed) { tickCounters[phase] += elapsed; tickRan[phase] = true; }
+    void endTick();
+    void endSession();
+    bool report() const;
+private:
+    bool loadBaseline(std::vector<PerfResult>& baseline) const;
+
+    std::string baselinePath;
+    bool updateBaseline;
+    std::string sessionName;
+    Uint64 tickCounters[PERF_PHASE_COUNT];
+    bool tickRan[PERF_PHASE_COUNT];
+    std::vector<double> samples[PERF_PHASE_COUNT];
+    std::vector<PerfResult> results;
+    double microsPerCount;
+};
+
+class PerfScope {
+public:
+    explicit PerfScope(PerfPhase scopePhase) : phase(scopePhase), start(PerfBench::active ? SDL_GetPerformanceCounter() : 0) {}
+    ~PerfScope() { if (PerfBench::active) PerfBench::active->add(phase, SDL_GetPerformanceCounter() - start); }
+private:
+    PerfPhase phase;
+    Uint64 start;
+};
+
+#define PERF_CONCAT_INNER(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_INNER(a, b)
+#define PERF_SCOPE(phase) PerfScope PERF_CONCAT(perfScope, __LINE__)(phase)
+
+#endif
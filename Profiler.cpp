@@ -0,0 +1,118 @@
+#ifdef UMBRAKED_PROFILE
+#include "Profiler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+static_assert((PROFILE_RING_SIZE & (PROFILE_RING_SIZE - 1)) == 0, "PROFILE_RING_SIZE must be a power of two");
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler() :
+    frame(0), frequency(SDL_GetPerformanceFrequency()), origin(SDL_GetPerformanceCounter()), lastFrameEnd(origin),
+    capturePending(false), captureReason("window"), captureStart(0), captureEnd(0), hitchCooldownUntil(0) {
+    const char* window = SDL_getenv("UMBRAKED_TRACE");
+    int first = 0, count = 0;
+    if (window && sscanf(window, "%d:%d", &first, &count) == 2 && count > 0) {
+        capturePending = true;
+        captureStart = static_cast<Uint32>(std::max(0, first));
+        captureEnd = captureStart + count - 1;
+    }
+}
+
+ProfileRing* Profiler::threadRing() {
+    static thread_local ProfileRing* ring = nullptr;
+    if (!ring) {
+        ring = new ProfileRing();
+        ring->head = 0;
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        ring->threadId = static_cast<int>(rings.size()) + 1;
+        rings.push_back(ring);
+    }
+    return ring;
+}
+
+void Profiler::record(const char* name, Uint64 start, Uint64 end) {
+    ProfileRing* ring = threadRing();
+    Uint32 index = ring->head.load(std::memory_order_relaxed);
+    ring->events[index & (PROFILE_RING_SIZE - 1)] = {name, start, end, frame.load(std::memory_order_relaxed)};
+    ring->head.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::captureFrames(int count) {
+    if (capturePending || count <= 0) return;
+    capturePending = true;
+    captureReason = "capture";
+    captureStart = frame + 1;
+    captureEnd = captureStart + count - 1;
+}
+
+void Profiler::endFrame(bool checkBudget) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint32 current = frame.load(std::memory_order_relaxed);
+    double frameMs = static_cast<double>(now - lastFrameEnd) * 1000.0 / frequency;
+    lastFrameEnd = now;
+
+    if (checkBudget && !capturePending && current >= hitchCooldownUntil && frameMs > PROFILE_HITCH_MS) {
+        printf("Frame %u took %.2f ms, capturing trace\n", current, frameMs);
+        capturePending = true;
+        captureReason = "hitch";
+        captureStart = current > PROFILE_HITCH_FRAMES_BEFORE ? current - PROFILE_HITCH_FRAMES_BEFORE : 0;
+        captureEnd = current + PROFILE_HITCH_FRAMES_AFTER;
+    }
+    if (capturePending && current >= captureEnd) {
+        dump(captureStart, captureEnd, captureReason);
+        capturePending = false;
+        hitchCooldownUntil = current + PROFILE_HITCH_COOLDOWN_FRAMES;
+    }
+    frame.store(current + 1, std::memory_order_relaxed);
+}
+
+void Profiler::dump(Uint32 firstFrame, Uint32 lastFrame, const char* reason) {
+    char path[64];
+    snprintf(path, sizeof(path), "trace_%s_%u.json", reason, firstFrame);
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        printf("Could not write trace %s\n", path);
+        return;
+    }
+
+    std::vector<ProfileRing*> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        snapshot = rings;
+    }
+
+    std::vector<ProfileEvent> events;
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    int written = 0;
+    for (ProfileRing* ring : snapshot) {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", ring->threadId, ring->threadId == 1 ? "main" : "worker");
+        first = false;
+        Uint32 head = ring->head.load(std::memory_order_acquire);
+        Uint32 begin = head > PROFILE_RING_SIZE ? head - PROFILE_RING_SIZE : 0;
+        events.assign(ring->events, ring->events + PROFILE_RING_SIZE);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // The owning thread keeps recording while we copy, so drop every slot it may have overwritten meanwhile.
+        Uint32 reached = ring->head.load(std::memory_order_relaxed);
+        if (reached - begin >= PROFILE_RING_SIZE) begin = reached - PROFILE_RING_SIZE + 1;
+        for (Uint32 i = begin; i < head; i++) {
+            const ProfileEvent& event = events[i & (PROFILE_RING_SIZE - 1)];
+            if (event.frame < firstFrame || event.frame > lastFrame || event.end < origin) continue;
+            double ts = static_cast<double>(event.start - origin) * 1000000.0 / frequency;
+            double dur = static_cast<double>(event.end - event.start) * 1000000.0 / frequency;
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+                    event.name, ring->threadId, ts, dur, event.frame);
+            written++;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    printf("Wrote %d trace events for frames %u-%u to %s\n", written, firstFrame, lastFrame, path);
+}
+#endif
@@ -0,0 +1,70 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#ifdef UMBRAKED_PROFILE
+#include <SDL.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "Config.h"
+
+struct ProfileEvent {
+    const char* name;
+    Uint64 start;
+    Uint64 end;
+    Uint32 frame;
+};
+
+struct ProfileRing {
+    ProfileEvent events[PROFILE_RING_SIZE];
+    std::atomic<Uint32> head;
+    int threadId;
+};
+
+class Profiler {
+public:
+    static Profiler& instance();
+    void record(const char* name, Uint64 start, Uint64 end);
+    void endFrame(bool checkBudget);
+    void captureFrames(int count);
+private:
+    Profiler();
+    ProfileRing* threadRing();
+    void dump(Uint32 firstFrame, Uint32 lastFrame, const char* reason);
+
+    std::mutex ringsMutex;
+    std::vector<ProfileRing*> rings;
+    std::atomic<Uint32> frame;
+    Uint64 frequency;
+    Uint64 origin;
+    Uint64 lastFrameEnd;
+    bool capturePending;
+    const char* captureReason;
+    Uint32 captureStart;
+    Uint32 captureEnd;
+    Uint32 hitchCooldownUntil;
+};
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* zoneName) :
+        profiler(Profiler::instance()), name(zoneName), start(SDL_GetPerformanceCounter()) {}
+    ~ProfileZone() { profiler.record(name, start, SDL_GetPerformanceCounter()); }
+private:
+    Profiler& profiler;
+    const char* name;
+    Uint64 start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FRAME(checkBudget) Profiler::instance().endFrame(checkBudget)
+#define PROFILE_CAPTURE(frames) Profiler::instance().captureFrames(frames)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FRAME(checkBudget) ((void)0)
+#define PROFILE_CAPTURE(frames) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,125 @@
+#include "ProjectileSystem.h"
+#include <algorithm>
+
+static Uint64 spanMask(int word, int left, int right) {
+    int first = std::max(left - word * 64, 0);
+    int last = std::min(right - word * 64, 64);
+    Uint64 below = last == 64 ? ~0ULL : (1ULL << last) - 1;
+    return below & (~0ULL << first);
+}
+
+ProjectileSystem::ProjectileSystem() : rows(SCREEN_HEIGHT * PROJECTILE_GRID_WORDS, 0), masks(), gridLeft(0), gridValid(false) {
+}
+
+void ProjectileSystem::clear() {
+    projectiles.clear();
+    projectiles.reserve(BULLET_RESERVE);
+    gridValid = false;
+}
+
+void ProjectileSystem::spawn(ProjectileTeam team, const SDL_Rect& rect, Fixed velocityX, Fixed velocityY, Fixed gravity) {
+    projectiles.push_back({rect, toFixed(rect.x), toFixed(rect.y), velocityX, velocityY, gravity, rect.x,
+                           static_cast<Uint8>(team), true});
+}
+
+void ProjectileSystem::update(Uint8 teamMask, const std::vector<Tile>& tiles, int cameraX) {
+    bool gridReady = false;
+    for (auto& projectile : projectiles) {
+        if (!projectile.active || !(projectile.team & teamMask)) continue;
+        int previousX = projectile.rect.x;
+        int previousY = projectile.rect.y;
+        projectile.velocityY += projectile.gravity;
+        projectile.positionX += projectile.velocityX;
+        projectile.positionY += projectile.velocityY;
+        projectile.rect.x = fixedToInt(projectile.positionX);
+        projectile.rect.y = fixedToInt(projectile.positionY);
+        if (std::abs(projectile.rect.x - projectile.startX) > BULLET_MAX_DISTANCE ||
+            projectile.rect.x < cameraX || projectile.rect.x > cameraX + SCREEN_WIDTH) {
+            projectile.active = false;
+            continue;
+        }
+        if (!gridReady) {
+            prepareGrid(tiles, cameraX);
+            gridReady = true;
+        }
+        if (sweepHits(std::min(previousX, projectile.rect.x), std::min(previousY, projectile.rect.y),
+                      std::max(previousX, projectile.rect.x) + projectile.rect.w,
+                      std::max(previousY, projectile.rect.y) + projectile.rect.h)) {
+            projectile.active = false;
+        }
+    }
+}
+
+bool ProjectileSystem::hit(Uint8 teamMask, const SDL_Rect& target, const CollisionMask* targetMask, bool targetFlipped) {
+    for (auto& projectile : projectiles) {
+        if (projectile.active && (projectile.team & teamMask) &&
+            CollisionMask::overlaps(projectile.rect, masks[projectile.team], false, target, targetMask, targetFlipped)) {
+            projectile.active = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ProjectileSystem::removeInactive() {
+    projectiles.erase(std::remove_if(projectiles.begin(), projectiles.end(),
+        [](const Projectile& p) { return !p.active; }), projectiles.end());
+}
+
+int ProjectileSystem::count(Uint8 teamMask) const {
+    return static_cast<int>(std::count_if(projectiles.begin(), projectiles.end(),
+        [teamMask](const Projectile& p) { return (p.team & teamMask) != 0; }));
+}
+
+void ProjectileSystem::addTile(const SDL_Rect& rect) {
+    if (gridValid) fillRect(rect);
+}
+
+void ProjectileSystem::restore(const std::vector<Projectile>& state) {
+    projectiles = state;
+    gridValid = false;
+}
+
+void ProjectileSystem::prepareGrid(const std::vector<Tile>& tiles, int cameraX) {
+    if (gridValid && cameraX - PROJECTILE_GRID_MARGIN / 2 >= gridLeft &&
+        cameraX + SCREEN_WIDTH + PROJECTILE_GRID_MARGIN / 2 <= gridLeft + PROJECTILE_GRID_WORDS * 64) {
+        return;
+    }
+    gridLeft = (cameraX - PROJECTILE_GRID_MARGIN) & ~63;
+    std::fill(rows.begin(), rows.end(), 0);
+    for (const auto& tile : tiles) fillRect(tile.rect);
+    gridValid = true;
+}
+
+void ProjectileSystem::fillRect(const SDL_Rect& rect) {
+    int left = std::max(rect.x - gridLeft, 0);
+    int right = std::min(rect.x + rect.w - gridLeft, PROJECTILE_GRID_WORDS * 64);
+    int top = std::max(rect.y, 0);
+    int bottom = std::min(rect.y + rect.h, SCREEN_HEIGHT);
+    if (left >= right || top >= bottom) return;
+    int lastWord = (right - 1) >> 6;
+    for (int y = top; y < bottom; y++) {
+        Uint64* row = &rows[y * PROJECTILE_GRID_WORDS];
+        for (int word = left >> 6; word <= lastWord; word++) row[word] |= spanMask(word, left, right);
+    }
+}
+
+bool ProjectileSystem::sweepHits(int left, int top, int right, int bottom) const {
+    left = std::max(left - gridLeft, 0);
+    right = std::min(right - gridLeft, PROJECTILE_GRID_WORDS * 64);
+    top = std::max(top, 0);
+    bottom = std::min(bottom, SCREEN_HEIGHT);
+    if (left >= right || top >= bottom) return false;
+    int firstWord = left >> 6;
+    int lastWord = (right - 1) >> 6;
+    Uint64 firstMask = spanMask(firstWord, left, right);
+    Uint64 lastMask = spanMask(lastWord, left, right);
+    for (int y = top; y < bottom; y++) {
+        const Uint64* row = &rows[y * PROJECTILE_GRID_WORDS];
+        Uint64 occupied = row[firstWord] & firstMask;
+        for (int word = firstWord + 1; word < lastWord; word++) occupied |= row[word];
+        if (lastWord != firstWord) occupied |= row[lastWord] & lastMask;
+        if (occupied) return true;
+    }
+    return false;
+}
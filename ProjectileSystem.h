@@ -0,0 +1,34 @@
+#ifndef PROJECTILE_SYSTEM_H
+#define PROJECTILE_SYSTEM_H
+#include <SDL.h>
+#include <vector>
+#include "Structs.h"
+#include "Config.h"
+#include "CollisionMask.h"
+
+class ProjectileSystem {
+public:
+    ProjectileSystem();
+    void clear();
+    void spawn(ProjectileTeam team, const SDL_Rect& rect, Fixed velocityX, Fixed velocityY = 0, Fixed gravity = 0);
+    void update(Uint8 teamMask, const std::vector<Tile>& tiles, int cameraX);
+    bool hit(Uint8 teamMask, const SDL_Rect& target, const CollisionMask* targetMask = nullptr, bool targetFlipped = false);
+    void setMask(ProjectileTeam team, const CollisionMask* mask) { masks[team] = mask; }
+    void removeInactive();
+    int count(Uint8 teamMask) const;
+    void addTile(const SDL_Rect& rect);
+    void restore(const std::vector<Projectile>& state);
+    const std::vector<Projectile>& getProjectiles() const { return projectiles; }
+private:
+    void prepareGrid(const std::vector<Tile>& tiles, int cameraX);
+    void fillRect(const SDL_Rect& rect);
+    bool sweepHits(int left, int top, int right, int bottom) const;
+
+    std::vector<Projectile> projectiles;
+    std::vector<Uint64> rows;
+    const CollisionMask* masks[TEAM_ENEMY + 1];
+    int gridLeft;
+    bool gridValid;
+};
+
+#endif
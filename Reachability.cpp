@@ -0,0 +1,120 @@
+#include "Reachability.h"
+#include <algorithm>
+
+static const int HEADROOM_CLASSES = REACH_MAX_RISE / REACH_HEADROOM_STEP + 1;
+static const int RISE_SPAN = REACH_MAX_RISE + SCREEN_HEIGHT + 1;
+
+static std::vector<Sint16> buildEnvelope() {
+    std::vector<Sint16> table(HEADROOM_CLASSES * RISE_SPAN, -1);
+    for (int headroomClass = 0; headroomClass < HEADROOM_CLASSES; headroomClass++) {
+        Sint16* row = &table[headroomClass * RISE_SPAN];
+        int ceiling = -headroomClass * REACH_HEADROOM_STEP;
+        Fixed y = 0;
+        Fixed velocityY = JUMP_FORCE;
+        int previous = 0;
+        for (int tick = 1; tick <= REACH_MAX_AIR_TICKS; tick++) {
+            velocityY += GRAVITY;
+            y += velocityY;
+            if (fixedToInt(y) < ceiling) {
+                y = toFixed(ceiling);
+                velocityY = 0;
+            }
+            int feet = fixedToInt(y);
+            if (velocityY > 0) {
+                for (int rise = std::max(previous, -REACH_MAX_RISE); rise <= std::min(feet, SCREEN_HEIGHT); rise++) {
+                    Sint16& cell = row[rise + REACH_MAX_RISE];
+                    if (cell < 0) cell = static_cast<Sint16>(tick * fixedToInt(PLAYER_SPEED));
+                }
+            }
+            previous = feet;
+        }
+    }
+    return table;
+}
+
+int ReachabilityValidator::reach(int headroom, int rise) {
+    static const std::vector<Sint16> envelope = buildEnvelope();
+    if (headroom < 0 || rise < -REACH_MAX_RISE || rise > SCREEN_HEIGHT) return -1;
+    int headroomClass = std::min(headroom, REACH_MAX_RISE) / REACH_HEADROOM_STEP;
+    return envelope[headroomClass * RISE_SPAN + rise + REACH_MAX_RISE];
+}
+
+bool ReachabilityValidator::canReach(int from, int to) const {
+    const TerrainSpan& source = surfaces[from];
+    const TerrainSpan& target = surfaces[to];
+    int gap = std::max(target.left - source.right, source.left - target.right);
+    int distance = reach(headrooms[from], target.top - source.top);
+    return distance >= 0 && gap - PLAYER_WIDTH + 2 <= distance;
+}
+
+bool ReachabilityValidator::check(const TerrainProfile& terrain, int left, int right, int exitY) {
+    terrain.findSurfaces(left - REACH_ENTRY_BAND, right, PLAYER_HEIGHT, spans);
+    surfaces.clear();
+    headrooms.clear();
+    for (const auto& span : spans) {
+        int head = span.top - PLAYER_HEIGHT;
+        for (int x = span.left; x < span.right;) {
+            int next = std::min(span.right, (x / TILE_SIZE + 1) * TILE_SIZE);
+            int ceiling;
+            int headroom = terrain.findCeiling(x, next, head, ceiling) ? head - ceiling : REACH_MAX_RISE;
+            if (!surfaces.empty() && surfaces.back().right == x && surfaces.back().top == span.top && headrooms.back() == headroom) {
+                surfaces.back().right = next;
+            } else {
+                surfaces.push_back({x, next, span.top, span.top});
+                headrooms.push_back(headroom);
+            }
+            x = next;
+        }
+    }
+    int exit = static_cast<int>(surfaces.size());
+    surfaces.push_back({right, right + REACH_EXIT_WIDTH, exitY, exitY});
+    headrooms.push_back(0);
+
+    reached.assign(surfaces.size(), 0);
+    pending.clear();
+    for (int i = 0; i < exit; i++) {
+        if (surfaces[i].left <= left) {
+            reached[i] = 1;
+            pending.push_back(i);
+        }
+    }
+    while (!pending.empty()) {
+        int from = pending.back();
+        pending.pop_back();
+        for (int to = 0; to <= exit; to++) {
+            if (reached[to] || !canReach(from, to)) continue;
+            if (to == exit) return true;
+            reached[to] = 1;
+            pending.push_back(to);
+        }
+    }
+    return false;
+}
+
+bool ReachabilityValidator::findPatch(const TerrainProfile& terrain, int exitY, SDL_Rect& block) const {
+    int frontier = -1;
+    for (int i = 0; i + 1 < static_cast<int>(surfaces.size()); i++) {
+        if (!reached[i]) continue;
+        if (frontier < 0 || surfaces[i].right > surfaces[frontier].right ||
+            (surfaces[i].right == surfaces[frontier].right && surfaces[i].top < surfaces[frontier].top)) {
+            frontier = i;
+        }
+    }
+    if (frontier < 0) return false;
+
+    const TerrainSpan& from = surfaces[frontier];
+    int heights[3] = {from.top + std::max(-REACH_PATCH_STEP, std::min(REACH_PATCH_STEP, exitY - from.top)),
+                      from.top, from.top + REACH_PATCH_STEP};
+    for (int y : heights) {
+        int distance = reach(headrooms[frontier], y - from.top);
+        if (distance < 0 || y > SCREEN_HEIGHT - TILE_SIZE) continue;
+        for (int step = REACH_PATCH_TRIES - 1; step >= 0; step--) {
+            int x = from.right + step * TILE_SIZE;
+            SDL_Rect room = {x, y - PLAYER_HEIGHT, REACH_PATCH_STEP, PLAYER_HEIGHT + TILE_SIZE};
+            if (x - from.right - PLAYER_WIDTH + 2 > distance || terrain.overlaps(room)) continue;
+            block = {x, y, REACH_PATCH_STEP, TILE_SIZE};
+            return true;
+        }
+    }
+    return false;
+}
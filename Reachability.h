@@ -0,0 +1,29 @@
+#ifndef REACHABILITY_H
+#define REACHABILITY_H
+#include <SDL.h>
+#include <vector>
+#include "Config.h"
+#include "TerrainProfile.h"
+
+struct ReachabilityStats {
+    long long chunks;
+    long long patched;
+    long long failed;
+};
+
+class ReachabilityValidator {
+public:
+    bool check(const TerrainProfile& terrain, int left, int right, int exitY);
+    bool findPatch(const TerrainProfile& terrain, int exitY, SDL_Rect& block) const;
+    static int reach(int headroom, int rise);
+private:
+    bool canReach(int from, int to) const;
+
+    std::vector<TerrainSpan> spans;
+    std::vector<TerrainSpan> surfaces;
+    std::vector<int> headrooms;
+    std::vector<int> pending;
+    std::vector<Uint8> reached;
+};
+
+#endif
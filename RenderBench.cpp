@@ -0,0 +1,108 @@
+#include "RenderBench.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+RenderBench::RenderBench(const char* dir, bool update) :
+    goldenDir(dir), updateGolden(update), goldenChecked(0), goldenFailed(0), goldenWritten(0) {
+}
+
+Uint8 RenderBench::scriptedInput(int tick) {
+    Uint8 input = INPUT_RIGHT;
+    if (tick % 40 < 12) input |= INPUT_JUMP;
+    if (tick % 15 == 0) input |= INPUT_FIRE;
+    if (tick % 240 >= 200) input = INPUT_LEFT;
+    return input;
+}
+
+void RenderBench::recordFrame(int tick, double renderMs, int drawCalls) {
+    samples.push_back({tick, renderMs, drawCalls});
+}
+
+bool RenderBench::checkGolden(int tick, SDL_Surface* frame) {
+    if (!frame) return true;
+    std::string path = goldenDir + "/frame_" + std::to_string(tick) + ".png";
+    if (updateGolden) {
+        if (IMG_SavePNG(frame, path.c_str()) != 0) {
+            printf("Failed to write golden image %s! IMG_Error: %s\n", path.c_str(), IMG_GetError());
+            goldenFailed++;
+            return false;
+        }
+        goldenWritten++;
+        return true;
+    }
+
+    goldenChecked++;
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if (!loaded) {
+        printf("Missing golden image %s (run with --update-golden to create it)\n", path.c_str());
+        goldenFailed++;
+        return false;
+    }
+    SDL_Surface* expected = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_Surface* actual = SDL_ConvertSurfaceFormat(frame, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+
+    bool passed = expected && actual && expected->w == actual->w && expected->h == actual->h;
+    if (passed) {
+        int differing = 0;
+        for (int y = 0; y < actual->h; y++) {
+            const Uint8* actualRow = static_cast<const Uint8*>(actual->pixels) + y * actual->pitch;
+            const Uint8* expectedRow = static_cast<const Uint8*>(expected->pixels) + y * expected->pitch;
+            for (int x = 0; x < actual->w * 4; x += 4) {
+                for (int channel = 0; channel < 3; channel++) {
+                    if (std::abs(actualRow[x + channel] - expectedRow[x + channel]) > RENDER_GOLDEN_CHANNEL_TOLERANCE) {
+                        differing++;
+                        break;
+                    }
+                }
+            }
+        }
+        double ratio = static_cast<double>(differing) / (actual->w * actual->h);
+        passed = ratio <= RENDER_GOLDEN_MAX_DIFF_RATIO;
+        printf("Golden %s: %.3f%% pixels differ %s\n", path.c_str(), ratio * 100.0, passed ? "(ok)" : "(FAILED)");
+    } else {
+        printf("Golden %s: size mismatch (FAILED)\n", path.c_str());
+    }
+    if (expected) SDL_FreeSurface(expected);
+    if (actual) SDL_FreeSurface(actual);
+    if (!passed) goldenFailed++;
+    return passed;
+}
+
+bool RenderBench::report() const {
+    if (samples.empty()) {
+        printf("Render benchmark produced no frames\n");
+        return false;
+    }
+    std::vector<double> times;
+    double totalMs = 0;
+    long long totalDraws = 0;
+    int maxDraws = 0;
+    for (const auto& sample : samples) {
+        times.push_back(sample.renderMs);
+        totalMs += sample.renderMs;
+        totalDraws += sample.drawCalls;
+        maxDraws = std::max(maxDraws, sample.drawCalls);
+    }
+    std::sort(times.begin(), times.end());
+    size_t count = times.size();
+    printf("Rendered %d frames: avg %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+           static_cast<int>(count), totalMs / count, times[count / 2], times[count * 95 / 100], times[count * 99 / 100],
+           times.back());
+    printf("Draw calls: avg %.1f, max %d\n", static_cast<double>(totalDraws) / count, maxDraws);
+
+    FILE* file = fopen(RENDER_BENCH_CSV_PATH, "w");
+    if (file) {
+        fprintf(file, "tick,render_ms,draw_calls\n");
+        for (const auto& sample : samples) fprintf(file, "%d,%.4f,%d\n", sample.tick, sample.renderMs, sample.drawCalls);
+        fclose(file);
+    } else {
+        printf("Failed to write %s\n", RENDER_BENCH_CSV_PATH);
+    }
+
+    if (updateGolden) printf("Wrote %d golden images to %s\n", goldenWritten, goldenDir.c_str());
+    else printf("Golden images: %d checked, %d failed\n", goldenChecked, goldenFailed);
+    return goldenFailed == 0;
+}
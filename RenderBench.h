@@ -0,0 +1,30 @@
+#ifndef RENDER_BENCH_H
+#define RENDER_BENCH_H
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include "Config.h"
+
+struct RenderFrameSample {
+    int tick;
+    double renderMs;
+    int drawCalls;
+};
+
+class RenderBench {
+public:
+    RenderBench(const char* goldenDir, bool updateGolden);
+    static Uint8 scriptedInput(int tick);
+    void recordFrame(int tick, double renderMs, int drawCalls);
+    bool checkGolden(int tick, SDL_Surface* frame);
+    bool report() const;
+private:
+    std::string goldenDir;
+    bool updateGolden;
+    std::vector<RenderFrameSample> samples;
+    int goldenChecked;
+    int goldenFailed;
+    int goldenWritten;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "RenderList.h"
+#include <cstring>
+
+void RenderList::create(int vertexCapacity) {
+    commands.reserve(RENDER_LIST_COMMANDS);
+    textBuffer.reserve(RENDER_LIST_TEXT_BYTES);
+    vertices.reserve(vertexCapacity);
+    scaleMode = RENDER_SCALE_DYNAMIC;
+    simulating = false;
+}
+
+void RenderList::clear() {
+    commands.clear();
+    textBuffer.clear();
+    vertices.clear();
+}
+
+void RenderList::sprite(int id, const SDL_Rect& rect, SDL_RendererFlip flip) {
+    commands.push_back({RENDER_SPRITE, static_cast<Uint8>(id), static_cast<Uint8>(flip), 0, rect, {0, 0, 0, 0}, 0});
+}
+
+void RenderList::text(const char* value, int x, int y, SDL_Color color, FontId font, bool center) {
+    int offset = static_cast<int>(textBuffer.size());
+    textBuffer.insert(textBuffer.end(), value, value + strlen(value) + 1);
+    commands.push_back({RENDER_TEXT, static_cast<Uint8>(font), 0, static_cast<Uint8>(center), {x, y, 0, 0}, color, offset});
+}
+
+void RenderList::line(int x1, int y1, int x2, int y2, SDL_Color color) {
+    commands.push_back({RENDER_LINE, 0, 0, 0, {x1, y1, x2, y2}, color, 0});
+}
+
+void RenderList::command(RenderOp op) {
+    commands.push_back({static_cast<Uint8>(op), 0, 0, 0, {0, 0, 0, 0}, {0, 0, 0, 0}, 0});
+}
+
+void RenderList::particles(int firstVertex, int quads) {
+    commands.push_back({RENDER_PARTICLES, 0, 0, 0, {firstVertex, 0, quads, 0}, {0, 0, 0, 0}, 0});
+}
+
+RenderBuffer::RenderBuffer() : shared(1), backIndex(0), frontIndex(2) {
+}
+
+void RenderBuffer::create(int vertexCapacity) {
+    for (auto& list : lists) list.create(vertexCapacity);
+}
+
+void RenderBuffer::publish() {
+    int previous = shared.exchange(backIndex | RENDER_BUFFER_FRESH, std::memory_order_acq_rel);
+    backIndex = previous & ~RENDER_BUFFER_FRESH;
+    lists[backIndex].clear();
+}
+
+const RenderList* RenderBuffer::acquire() {
+    if (!hasFresh()) return nullptr;
+    int previous = shared.exchange(frontIndex, std::memory_order_acq_rel);
+    frontIndex = previous & ~RENDER_BUFFER_FRESH;
+    return &lists[frontIndex];
+}
@@ -0,0 +1,65 @@
+#ifndef RENDER_LIST_H
+#define RENDER_LIST_H
+#include <SDL.h>
+#include <atomic>
+#include <vector>
+#include "Config.h"
+
+enum SpriteId {
+    SPRITE_BACKGROUND, SPRITE_GROUND, SPRITE_FLOATING, SPRITE_SPIKE, SPRITE_ENEMY,
+    SPRITE_BULLET = SPRITE_ENEMY + ENEMY_TYPE_COUNT, SPRITE_ENEMY_BULLET, SPRITE_PLAYER, SPRITE_HEART,
+    SPRITE_COUNT = SPRITE_HEART + HEART_TEXTURE_COUNT
+};
+enum FontId { FONT_BODY, FONT_TITLE, FONT_SCORE, FONT_COUNT };
+enum RenderOp { RENDER_SPRITE, RENDER_TEXT, RENDER_LINE, RENDER_BEGIN_WORLD, RENDER_END_WORLD, RENDER_PARTICLES };
+
+struct RenderCommand {
+    Uint8 op;
+    Uint8 id;
+    Uint8 flip;
+    Uint8 center;
+    SDL_Rect rect;
+    SDL_Color color;
+    int text;
+};
+
+class RenderList {
+public:
+    void create(int vertexCapacity);
+    void clear();
+    void sprite(int id, const SDL_Rect& rect, SDL_RendererFlip flip = SDL_FLIP_NONE);
+    void text(const char* value, int x, int y, SDL_Color color, FontId font, bool center = false);
+    void line(int x1, int y1, int x2, int y2, SDL_Color color);
+    void command(RenderOp op);
+    void particles(int firstVertex, int quads);
+    std::vector<SDL_Vertex>& getVertexBuffer() { return vertices; }
+    const std::vector<RenderCommand>& getCommands() const { return commands; }
+    const char* getText(int offset) const { return &textBuffer[offset]; }
+    const SDL_Vertex* getVertices(int first) const { return &vertices[first]; }
+
+    RenderScaleMode scaleMode;
+    bool simulating;
+private:
+    std::vector<RenderCommand> commands;
+    std::vector<char> textBuffer;
+    std::vector<SDL_Vertex> vertices;
+};
+
+class RenderBuffer {
+public:
+    RenderBuffer();
+    void create(int vertexCapacity);
+    RenderList& back() { return lists[backIndex]; }
+    void publish();
+    const RenderList* acquire();
+    bool hasFresh() const { return (shared.load(std::memory_order_acquire) & RENDER_BUFFER_FRESH) != 0; }
+private:
+    static const int RENDER_BUFFER_FRESH = 4;
+
+    RenderList lists[3];
+    std::atomic<int> shared;
+    int backIndex;
+    int frontIndex;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "RenderScaler.h"
+#include <algorithm>
+#include <cstdio>
+
+RenderScaler::RenderScaler() :
+    renderer(nullptr), target(nullptr), mode(RENDER_SCALE_DYNAMIC), divisor(1), drawingToTarget(false),
+    lastChangeRaised(false), framesSinceChange(0), probeFrames(RENDER_SCALE_PROBE_FRAMES),
+    averageFrameMs(RENDER_FRAME_BUDGET_MS), lastFrameCounter(0) {
+}
+
+bool RenderScaler::create(SDL_Renderer* sdlRenderer) {
+    destroy();
+    renderer = sdlRenderer;
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+    target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (!target) {
+        printf("Render target unavailable, drawing at native resolution. SDL_Error: %s\n", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+void RenderScaler::destroy() {
+    if (target) SDL_DestroyTexture(target);
+    target = nullptr;
+}
+
+void RenderScaler::setMode(RenderScaleMode newMode) {
+    mode = newMode;
+    probeFrames = RENDER_SCALE_PROBE_FRAMES;
+    lastChangeRaised = false;
+    setDivisor(mode == RENDER_SCALE_LOW ? RENDER_LOW_DIVISOR : 1);
+}
+
+void RenderScaler::setDivisor(int value) {
+    if (value != divisor) printf("Render scale: 1/%d\n", value);
+    divisor = value;
+    framesSinceChange = 0;
+    averageFrameMs = RENDER_FRAME_BUDGET_MS;
+}
+
+void RenderScaler::beginWorld() {
+    drawingToTarget = target && divisor > 1;
+    if (!drawingToTarget) return;
+    SDL_SetRenderTarget(renderer, target);
+    SDL_RenderSetScale(renderer, 1.0f / divisor, 1.0f / divisor);
+    SDL_RenderClear(renderer);
+}
+
+void RenderScaler::endWorld() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (lastFrameCounter) recordFrame(static_cast<double>(now - lastFrameCounter) * 1000.0 / SDL_GetPerformanceFrequency());
+    lastFrameCounter = now;
+
+    if (!drawingToTarget) return;
+    drawingToTarget = false;
+    SDL_SetRenderTarget(renderer, nullptr);
+    SDL_RenderSetScale(renderer, 1.0f, 1.0f);
+    SDL_Rect source = {0, 0, SCREEN_WIDTH / divisor, SCREEN_HEIGHT / divisor};
+    SDL_RenderCopy(renderer, target, &source, NULL);
+}
+
+void RenderScaler::recordFrame(double frameMs) {
+    if (frameMs > RENDER_SCALE_GAP_MS) return;
+    averageFrameMs += (frameMs - averageFrameMs) * RENDER_SCALE_SMOOTHING;
+    framesSinceChange++;
+    if (mode != RENDER_SCALE_DYNAMIC || !target || framesSinceChange < RENDER_SCALE_SETTLE_FRAMES) return;
+
+    if (averageFrameMs > RENDER_SCALE_DOWN_MS && divisor < RENDER_MAX_DIVISOR) {
+        if (lastChangeRaised && framesSinceChange < probeFrames) probeFrames = std::min(probeFrames * 2, RENDER_SCALE_MAX_PROBE_FRAMES);
+        lastChangeRaised = false;
+        setDivisor(divisor * 2);
+    } else if (averageFrameMs < RENDER_SCALE_UP_MS && divisor > 1 && framesSinceChange >= probeFrames) {
+        lastChangeRaised = true;
+        setDivisor(divisor / 2);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef RENDER_SCALER_H
+#define RENDER_SCALER_H
+#include <SDL.h>
+#include "Config.h"
+
+class RenderScaler {
+public:
+    RenderScaler();
+    bool create(SDL_Renderer* renderer);
+    void destroy();
+    void setMode(RenderScaleMode mode);
+    RenderScaleMode getMode() const { return mode; }
+    int getDivisor() const { return divisor; }
+    void beginWorld();
+    void endWorld();
+private:
+    void recordFrame(double frameMs);
+    void setDivisor(int value);
+
+    SDL_Renderer* renderer;
+    SDL_Texture* target;
+    RenderScaleMode mode;
+    int divisor;
+    bool drawingToTarget;
+    bool lastChangeRaised;
+    int framesSinceChange;
+    int probeFrames;
+    double averageFrameMs;
+    Uint64 lastFrameCounter;
+};
+
+#endif
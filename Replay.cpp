@@ -0,0 +1,155 @@
+#include "Replay.h"
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+const char REPLAY_MAGIC[4] = {'U', 'M', 'R', 'P'};
+const Uint32 REPLAY_VERSION = 2;
+
+void writeU32(std::vector<Uint8>& out, Uint32 value) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<Uint8>(value >> (i * 8)));
+}
+
+void writeVarint(std::vector<Uint8>& out, Uint32 value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<Uint8>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<Uint8>(value));
+}
+
+bool readU32(const std::vector<Uint8>& in, size_t& pos, Uint32& value) {
+    if (pos + 4 > in.size()) return false;
+    value = 0;
+    for (int i = 0; i < 4; i++) value |= static_cast<Uint32>(in[pos + i]) << (i * 8);
+    pos += 4;
+    return true;
+}
+
+bool readVarint(const std::vector<Uint8>& in, size_t& pos, Uint32& value) {
+    value = 0;
+    for (int shift = 0; shift < 32 && pos < in.size(); shift += 7) {
+        Uint8 byte = in[pos++];
+        value |= static_cast<Uint32>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+}
+
+Replay::Replay() : seed(0), cursor(0) {
+}
+
+void Replay::beginRecording(Uint32 runSeed) {
+    seed = runSeed;
+    inputs.clear();
+    checksums.clear();
+    inputs.reserve(REPLAY_RESERVE_TICKS);
+    checksums.reserve(REPLAY_RESERVE_TICKS / REPLAY_CHECKSUM_INTERVAL);
+    cursor = 0;
+}
+
+void Replay::recordInput(Uint8 input) {
+    inputs.push_back(input);
+}
+
+void Replay::recordChecksum(Uint32 checksum) {
+    checksums.push_back(checksum);
+}
+
+std::vector<Uint8> Replay::serialize() const {
+    std::vector<Uint8> stream;
+    Uint8 previous = 0;
+    Uint32 lastChange = 0;
+    for (size_t tick = 0; tick < inputs.size(); tick++) {
+        Uint8 delta = inputs[tick] ^ previous;
+        if (delta == 0) continue;
+        writeVarint(stream, ((static_cast<Uint32>(tick) - lastChange) << 4) | (delta & 0x0F));
+        lastChange = static_cast<Uint32>(tick);
+        previous = inputs[tick];
+    }
+
+    std::vector<Uint8> out(REPLAY_MAGIC, REPLAY_MAGIC + 4);
+    writeU32(out, REPLAY_VERSION);
+    writeU32(out, seed);
+    writeU32(out, static_cast<Uint32>(inputs.size()));
+    writeU32(out, REPLAY_CHECKSUM_INTERVAL);
+    writeU32(out, static_cast<Uint32>(checksums.size()));
+    writeU32(out, static_cast<Uint32>(stream.size()));
+    for (Uint32 checksum : checksums) writeU32(out, checksum);
+    out.insert(out.end(), stream.begin(), stream.end());
+    return out;
+}
+
+bool Replay::load(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        printf("Could not open replay %s\n", path);
+        return false;
+    }
+    std::vector<Uint8> data;
+    Uint8 buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) data.insert(data.end(), buffer, buffer + read);
+    fclose(file);
+
+    size_t pos = 4;
+    Uint32 version, tickCount, interval, checksumCount, streamBytes;
+    if (data.size() < 4 || memcmp(data.data(), REPLAY_MAGIC, 4) != 0 ||
+        !readU32(data, pos, version) || version != REPLAY_VERSION || !readU32(data, pos, seed) ||
+        !readU32(data, pos, tickCount) || !readU32(data, pos, interval) || interval != REPLAY_CHECKSUM_INTERVAL ||
+        !readU32(data, pos, checksumCount) || !readU32(data, pos, streamBytes)) {
+        printf("Replay %s has an unsupported header\n", path);
+        return false;
+    }
+
+    // Recording stores one checksum per interval, so both counts are bounded by the bytes actually present.
+    size_t remaining = data.size() - pos;
+    if (checksumCount > remaining / 4 || checksumCount != tickCount / REPLAY_CHECKSUM_INTERVAL ||
+        streamBytes > remaining - checksumCount * 4) {
+        printf("Replay %s is truncated or corrupt\n", path);
+        return false;
+    }
+
+    checksums.resize(checksumCount);
+    for (auto& checksum : checksums) readU32(data, pos, checksum);
+
+    inputs.assign(tickCount, 0);
+    size_t end = pos + streamBytes;
+    Uint8 current = 0;
+    Uint32 tick = 0;
+    while (pos < end) {
+        Uint32 packed;
+        if (!readVarint(data, pos, packed)) return false;
+        Uint32 changeTick = tick + (packed >> 4);
+        if (changeTick >= tickCount) return false;
+        for (Uint32 t = tick; t < changeTick; t++) inputs[t] = current;
+        current ^= packed & 0x0F;
+        tick = changeTick;
+    }
+    for (Uint32 t = tick; t < tickCount; t++) inputs[t] = current;
+    cursor = 0;
+    return true;
+}
+
+void Replay::rewind(int tick) {
+    cursor = tick < 0 ? 0 : static_cast<size_t>(tick);
+}
+
+void Replay::truncate(int tick) {
+    size_t length = tick < 0 ? 0 : static_cast<size_t>(tick);
+    if (length < inputs.size()) inputs.resize(length);
+    if (length / REPLAY_CHECKSUM_INTERVAL < checksums.size()) checksums.resize(length / REPLAY_CHECKSUM_INTERVAL);
+    cursor = std::min(cursor, inputs.size());
+}
+
+Uint8 Replay::nextInput() {
+    return cursor < inputs.size() ? inputs[cursor++] : 0;
+}
+
+bool Replay::checkChecksum(int tick, Uint32 checksum) const {
+    if (tick <= 0 || tick % REPLAY_CHECKSUM_INTERVAL != 0) return true;
+    size_t index = tick / REPLAY_CHECKSUM_INTERVAL - 1;
+    return index >= checksums.size() || checksums[index] == checksum;
+}
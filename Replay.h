@@ -0,0 +1,31 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+#include <SDL.h>
+#include <vector>
+#include "Config.h"
+
+enum ReplayMode { REPLAY_OFF, REPLAY_REALTIME, REPLAY_FAST };
+
+class Replay {
+public:
+    Replay();
+    void beginRecording(Uint32 seed);
+    void recordInput(Uint8 input);
+    void recordChecksum(Uint32 checksum);
+    std::vector<Uint8> serialize() const;
+    bool load(const char* path);
+    void rewind(int tick);
+    void truncate(int tick);
+    bool hasInput() const { return cursor < inputs.size(); }
+    Uint8 nextInput();
+    bool checkChecksum(int tick, Uint32 checksum) const;
+    Uint32 getSeed() const { return seed; }
+    int getTickCount() const { return static_cast<int>(inputs.size()); }
+private:
+    Uint32 seed;
+    std::vector<Uint8> inputs;
+    std::vector<Uint32> checksums;
+    size_t cursor;
+};
+
+#endif
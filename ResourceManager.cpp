@@ -1,115 +1,159 @@
 #include "ResourceManager.h"
+#include "Profiler.h"
+#include "Utils.h"
 #include <SDL_image.h>
 #include <cstdio>
 
-ResourceManager::ResourceManager(SDL_Renderer* rend) : renderer(rend),
-    playerTexture(nullptr), groundTexture(nullptr), floatingTexture(nullptr),
-    enemy1Texture(nullptr), enemy2Texture(nullptr), enemy3Texture(nullptr),
-    enemy4Texture(nullptr), enemy5Texture(nullptr), bulletTexture(nullptr),
-    enemyBulletTexture(nullptr), backgroundTexture(nullptr), spikeTexture(nullptr),
-    hitSound(nullptr), shootSound(nullptr), boomSound(nullptr), jumpSound(nullptr),
-    inGameMusic(nullptr), menuMusic(nullptr), font(nullptr), titleFont(nullptr),
-    enemy4AspectRatio(1.0f), enemy5AspectRatio(1.0f) {
+static const char* resourceTypeNames[RESOURCE_TYPE_COUNT] = {"textures", "sounds", "music", "fonts"};
+
+static size_t fileSize(const char* path) {
+    SDL_RWops* file = SDL_RWFromFile(path, "rb");
+    if (!file) return 0;
+    Sint64 size = SDL_RWsize(file);
+    SDL_RWclose(file);
+    return size > 0 ? static_cast<size_t>(size) : 0;
+}
+
+ResourceManager::ResourceManager() : renderer(nullptr), liveCounts(), liveBytes(), decodes(0), hits(0) {
 }
 
 ResourceManager::~ResourceManager() {
-    freeResources();
+    destroy();
 }
 
-bool ResourceManager::loadResources() {
-    font = TTF_OpenFont(FONT_PATH, FONT_SIZE);
-    titleFont = TTF_OpenFont(TITLE_FONT_PATH, 72);
-    if (!font || !titleFont) return false;
-
-    SDL_Surface* surface;
-    surface = IMG_Load(PLAYER_IMAGE_PATH); playerTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(GROUND_TILE_PATH); groundTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(FLOATING_TILE_PATH); floatingTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(ENEMY1_IMAGE_PATH); enemy1Texture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(ENEMY2_IMAGE_PATH); enemy2Texture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(ENEMY3_IMAGE_PATH); enemy3Texture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-
-    surface = IMG_Load(ENEMY4_IMAGE_PATH);
-    enemy4Texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (surface) {
-        enemy4AspectRatio = static_cast<float>(surface->w) / surface->h;
-        SDL_FreeSurface(surface);
-    } else {
-        printf("Failed to load enemy4.png! SDL_Error: %s\n", SDL_GetError());
-        enemy4AspectRatio = 1.0f;
+void ResourceManager::create(SDL_Renderer* sdlRenderer) {
+    destroy();
+    renderer = sdlRenderer;
+}
+
+void ResourceManager::destroy() {
+    for (auto& entry : entries) {
+        if (!entry.data) continue;
+        if (entry.refs > 0) printf("Resource %s freed with %d live handles\n", entry.key.c_str(), entry.refs);
+        unload(entry);
     }
+    entries.clear();
+    freeSlots.clear();
+    renderer = nullptr;
+}
 
-    surface = IMG_Load(ENEMY5_IMAGE_PATH);
-    enemy5Texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (surface) {
-        enemy5AspectRatio = static_cast<float>(surface->w) / surface->h;
-        SDL_FreeSurface(surface);
+int ResourceManager::find(const std::string& key, ResourceType type) {
+    Uint32 hash = hashBytes(key.data(), key.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].data && entries[i].type == type && entries[i].hash == hash && entries[i].key == key) {
+            retain(static_cast<int>(i));
+            hits++;
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int ResourceManager::insert(const std::string& key, ResourceType type, void* data, int width, int height, size_t bytes) {
+    int slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
     } else {
-        printf("Failed to load enemy5.png! SDL_Error: %s\n", SDL_GetError());
-        enemy5AspectRatio = 1.0f;
+        slot = static_cast<int>(entries.size());
+        entries.emplace_back();
     }
+    entries[slot] = {key, hashBytes(key.data(), key.size()), type, data, 1, width, height, bytes};
+    liveCounts[type]++;
+    liveBytes[type] += bytes;
+    decodes++;
+    return slot;
+}
 
-    surface = IMG_Load(BULLET_IMAGE_PATH); bulletTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(ENEMY_BULLET_IMAGE_PATH); enemyBulletTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(BACKGROUND_IMAGE_PATH); backgroundTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
-    surface = IMG_Load(SPIKE_IMAGE_PATH); spikeTexture = SDL_CreateTextureFromSurface(renderer, surface); SDL_FreeSurface(surface);
+void ResourceManager::release(int slot) {
+    if (slot < 0 || slot >= static_cast<int>(entries.size()) || !entries[slot].data) return;
+    if (--entries[slot].refs > 0) return;
+    unload(entries[slot]);
+    freeSlots.push_back(slot);
+}
 
-    surface = IMG_Load(LIVE_IMAGE_PATH);
-    heartTextures.push_back(SDL_CreateTextureFromSurface(renderer, surface));
-    heartTextures.push_back(SDL_CreateTextureFromSurface(renderer, surface));
-    heartTextures.push_back(SDL_CreateTextureFromSurface(renderer, surface));
-    SDL_FreeSurface(surface);
-    surface = IMG_Load(DIE_IMAGE_PATH);
-    heartTextures.push_back(SDL_CreateTextureFromSurface(renderer, surface));
+void ResourceManager::unload(ResourceEntry& entry) {
+    switch (entry.type) {
+        case RESOURCE_TEXTURE: SDL_DestroyTexture(static_cast<SDL_Texture*>(entry.data)); break;
+        case RESOURCE_SOUND: Mix_FreeChunk(static_cast<Mix_Chunk*>(entry.data)); break;
+        case RESOURCE_MUSIC: Mix_FreeMusic(static_cast<Mix_Music*>(entry.data)); break;
+        case RESOURCE_FONT: TTF_CloseFont(static_cast<TTF_Font*>(entry.data)); break;
+        default: break;
+    }
+    liveCounts[entry.type]--;
+    liveBytes[entry.type] -= entry.bytes;
+    entry.data = nullptr;
+    entry.refs = 0;
+    entry.key.clear();
+}
+
+TextureHandle ResourceManager::loadTexture(const char* path) {
+    std::string key = path;
+    int slot = find(key, RESOURCE_TEXTURE);
+    if (slot >= 0) return TextureHandle(this, slot, static_cast<SDL_Texture*>(entries[slot].data));
+
+    PROFILE_ZONE("ResourceManager::loadTexture");
+    SDL_Surface* surface = IMG_Load(path);
+    if (!surface) {
+        printf("Failed to load %s! SDL_image Error: %s\n", path, IMG_GetError());
+        return TextureHandle();
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    int width = surface->w;
+    int height = surface->h;
     SDL_FreeSurface(surface);
+    if (!texture) {
+        printf("Failed to create texture for %s! SDL_Error: %s\n", path, SDL_GetError());
+        return TextureHandle();
+    }
+    Uint32 format = 0;
+    SDL_QueryTexture(texture, &format, nullptr, nullptr, nullptr);
+    size_t bytes = static_cast<size_t>(width) * height * SDL_BYTESPERPIXEL(format);
+    return TextureHandle(this, insert(key, RESOURCE_TEXTURE, texture, width, height, bytes), texture);
+}
 
-    hitSound = Mix_LoadWAV(HIT_SOUND_PATH);
-    shootSound = Mix_LoadWAV(SHOOT_SOUND_PATH);
-    boomSound = Mix_LoadWAV(BOOM_SOUND_PATH);
-    jumpSound = Mix_LoadWAV(JUMP_SOUND_PATH);
-    inGameMusic = Mix_LoadMUS(INGAME_SOUND_PATH);
-    menuMusic = Mix_LoadMUS(MENU_SOUND_PATH);
+SoundHandle ResourceManager::loadSound(const char* path) {
+    std::string key = path;
+    int slot = find(key, RESOURCE_SOUND);
+    if (slot >= 0) return SoundHandle(this, slot, static_cast<Mix_Chunk*>(entries[slot].data));
 
-    Mix_VolumeMusic(64);
+    Mix_Chunk* chunk = Mix_LoadWAV(path);
+    if (!chunk) {
+        printf("Failed to load %s! SDL_mixer Error: %s\n", path, Mix_GetError());
+        return SoundHandle();
+    }
+    return SoundHandle(this, insert(key, RESOURCE_SOUND, chunk, 0, 0, chunk->alen), chunk);
+}
+
+MusicHandle ResourceManager::loadMusic(const char* path) {
+    std::string key = path;
+    int slot = find(key, RESOURCE_MUSIC);
+    if (slot >= 0) return MusicHandle(this, slot, static_cast<Mix_Music*>(entries[slot].data));
 
-    return playerTexture && groundTexture && floatingTexture && enemy1Texture && enemy2Texture &&
-           enemy3Texture && enemy4Texture && enemy5Texture && bulletTexture && enemyBulletTexture &&
-           backgroundTexture && spikeTexture && heartTextures.size() == 4 && hitSound && shootSound &&
-           boomSound && jumpSound && inGameMusic && menuMusic;
+    Mix_Music* music = Mix_LoadMUS(path);
+    if (!music) {
+        printf("Failed to load %s! SDL_mixer Error: %s\n", path, Mix_GetError());
+        return MusicHandle();
+    }
+    return MusicHandle(this, insert(key, RESOURCE_MUSIC, music, 0, 0, fileSize(path)), music);
 }
 
-void ResourceManager::freeResources() {
-    SDL_DestroyTexture(playerTexture);
-    SDL_DestroyTexture(groundTexture);
-    SDL_DestroyTexture(floatingTexture);
-    SDL_DestroyTexture(enemy1Texture);
-    SDL_DestroyTexture(enemy2Texture);
-    SDL_DestroyTexture(enemy3Texture);
-    SDL_DestroyTexture(enemy4Texture);
-    SDL_DestroyTexture(enemy5Texture);
-    SDL_DestroyTexture(bulletTexture);
-    SDL_DestroyTexture(enemyBulletTexture);
-    SDL_DestroyTexture(backgroundTexture);
-    SDL_DestroyTexture(spikeTexture);
-    for (auto texture : heartTextures) SDL_DestroyTexture(texture);
-    heartTextures.clear();
-    Mix_FreeChunk(hitSound);
-    Mix_FreeChunk(shootSound);
-    Mix_FreeChunk(boomSound);
-    Mix_FreeChunk(jumpSound);
-    Mix_FreeMusic(inGameMusic);
-    Mix_FreeMusic(menuMusic);
-    TTF_CloseFont(font);
-    TTF_CloseFont(titleFont);
+FontHandle ResourceManager::loadFont(const char* path, int size) {
+    std::string key = std::string(path) + "@" + std::to_string(size);
+    int slot = find(key, RESOURCE_FONT);
+    if (slot >= 0) return FontHandle(this, slot, static_cast<TTF_Font*>(entries[slot].data));
+
+    TTF_Font* font = TTF_OpenFont(path, size);
+    if (!font) {
+        printf("Failed to load %s! SDL_ttf Error: %s\n", path, TTF_GetError());
+        return FontHandle();
+    }
+    return FontHandle(this, insert(key, RESOURCE_FONT, font, 0, 0, fileSize(path)), font);
 }
 
-SDL_Texture* ResourceManager::getEnemyTexture(int type) const {
-    switch (type) {
-        case 0: return enemy1Texture;
-        case 1: return enemy2Texture;
-        case 2: return enemy3Texture;
-        case 3: return enemy4Texture;
-        case 4: return enemy5Texture;
-        default: return nullptr;
+void ResourceManager::printStats() const {
+    printf("Resources: %d decoded, %d cache hits\n", decodes, hits);
+    for (int type = 0; type < RESOURCE_TYPE_COUNT; type++) {
+        printf("  %-8s %3d live, %.1f KB\n", resourceTypeNames[type], liveCounts[type], liveBytes[type] / 1024.0);
     }
 }
@@ -3,57 +3,113 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
+#include <string>
+#include <utility>
 #include <vector>
 #include "Config.h"
+
+enum ResourceType { RESOURCE_TEXTURE, RESOURCE_SOUND, RESOURCE_MUSIC, RESOURCE_FONT, RESOURCE_TYPE_COUNT };
+
+struct ResourceEntry {
+    std::string key;
+    Uint32 hash;
+    ResourceType type;
+    void* data;
+    int refs;
+    int width;
+    int height;
+    size_t bytes;
+};
+
+class ResourceManager;
+
+template <typename T>
+class ResourceHandle {
+public:
+    ResourceHandle() : owner(nullptr), slot(-1), data(nullptr) {}
+    ResourceHandle(const ResourceHandle& other);
+    ResourceHandle(ResourceHandle&& other) : owner(other.owner), slot(other.slot), data(other.data) { other.detach(); }
+    ResourceHandle& operator=(ResourceHandle other);
+    ~ResourceHandle() { reset(); }
+    void reset();
+    T* get() const { return data; }
+    explicit operator bool() const { return data != nullptr; }
+    int getWidth() const;
+    int getHeight() const;
+private:
+    friend class ResourceManager;
+    ResourceHandle(ResourceManager* manager, int entry, T* resource) : owner(manager), slot(entry), data(resource) {}
+    void detach() { owner = nullptr; slot = -1; data = nullptr; }
+
+    ResourceManager* owner;
+    int slot;
+    T* data;
+};
+
+typedef ResourceHandle<SDL_Texture> TextureHandle;
+typedef ResourceHandle<Mix_Chunk> SoundHandle;
+typedef ResourceHandle<Mix_Music> MusicHandle;
+typedef ResourceHandle<TTF_Font> FontHandle;
+
 class ResourceManager {
 public:
-    ResourceManager(SDL_Renderer* renderer);
+    ResourceManager();
     ~ResourceManager();
-    bool loadResources();
-    void freeResources();
-    SDL_Texture* getPlayerTexture() const { return playerTexture; }
-    SDL_Texture* getGroundTexture() const { return groundTexture; }
-    SDL_Texture* getFloatingTexture() const { return floatingTexture; }
-    SDL_Texture* getEnemyTexture(int type) const;
-    SDL_Texture* getBulletTexture() const { return bulletTexture; }
-    SDL_Texture* getEnemyBulletTexture() const { return enemyBulletTexture; }
-    SDL_Texture* getBackgroundTexture() const { return backgroundTexture; }
-    SDL_Texture* getSpikeTexture() const { return spikeTexture; }
-    SDL_Texture* getHeartTexture(int index) const { return heartTextures[index]; }
-    Mix_Chunk* getHitSound() const { return hitSound; }
-    Mix_Chunk* getShootSound() const { return shootSound; }
-    Mix_Chunk* getBoomSound() const { return boomSound; }
-    Mix_Chunk* getJumpSound() const { return jumpSound; }
-    Mix_Music* getInGameMusic() const { return inGameMusic; }
-    Mix_Music* getMenuMusic() const { return menuMusic; }
-    TTF_Font* getFont() const { return font; }
-    TTF_Font* getTitleFont() const { return titleFont; }
-    float getEnemy4AspectRatio() const { return enemy4AspectRatio; }
-    float getEnemy5AspectRatio() const { return enemy5AspectRatio; }
+    void create(SDL_Renderer* renderer);
+    void destroy();
+    TextureHandle loadTexture(const char* path);
+    SoundHandle loadSound(const char* path);
+    MusicHandle loadMusic(const char* path);
+    FontHandle loadFont(const char* path, int size);
+    int getLiveCount(ResourceType type) const { return liveCounts[type]; }
+    size_t getLiveBytes(ResourceType type) const { return liveBytes[type]; }
+    int getDecodeCount() const { return decodes; }
+    void printStats() const;
 private:
+    template <typename T> friend class ResourceHandle;
+    int find(const std::string& key, ResourceType type);
+    int insert(const std::string& key, ResourceType type, void* data, int width, int height, size_t bytes);
+    void retain(int slot) { entries[slot].refs++; }
+    void release(int slot);
+    void unload(ResourceEntry& entry);
+    const ResourceEntry& entry(int slot) const { return entries[slot]; }
+
     SDL_Renderer* renderer;
-    SDL_Texture* playerTexture;
-    SDL_Texture* groundTexture;
-    SDL_Texture* floatingTexture;
-    SDL_Texture* enemy1Texture;
-    SDL_Texture* enemy2Texture;
-    SDL_Texture* enemy3Texture;
-    SDL_Texture* enemy4Texture;
-    SDL_Texture* enemy5Texture;
-    SDL_Texture* bulletTexture;
-    SDL_Texture* enemyBulletTexture;
-    SDL_Texture* backgroundTexture;
-    SDL_Texture* spikeTexture;
-    std::vector<SDL_Texture*> heartTextures;
-    Mix_Chunk* hitSound;
-    Mix_Chunk* shootSound;
-    Mix_Chunk* boomSound;
-    Mix_Chunk* jumpSound;
-    Mix_Music* inGameMusic;
-    Mix_Music* menuMusic;
-    TTF_Font* font;
-    TTF_Font* titleFont;
-    float enemy4AspectRatio;
-    float enemy5AspectRatio;
+    std::vector<ResourceEntry> entries;
+    std::vector<int> freeSlots;
+    int liveCounts[RESOURCE_TYPE_COUNT];
+    size_t liveBytes[RESOURCE_TYPE_COUNT];
+    int decodes;
+    int hits;
 };
+
+template <typename T>
+ResourceHandle<T>::ResourceHandle(const ResourceHandle& other) : owner(other.owner), slot(other.slot), data(other.data) {
+    if (owner) owner->retain(slot);
+}
+
+template <typename T>
+ResourceHandle<T>& ResourceHandle<T>::operator=(ResourceHandle other) {
+    std::swap(owner, other.owner);
+    std::swap(slot, other.slot);
+    std::swap(data, other.data);
+    return *this;
+}
+
+template <typename T>
+void ResourceHandle<T>::reset() {
+    if (owner) owner->release(slot);
+    detach();
+}
+
+template <typename T>
+int ResourceHandle<T>::getWidth() const {
+    return owner ? owner->entry(slot).width : 0;
+}
+
+template <typename T>
+int ResourceHandle<T>::getHeight() const {
+    return owner ? owner->entry(slot).height : 0;
+}
+
 #endif
@@ -0,0 +1,229 @@
+#include "RollbackSession.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+static_assert(NET_ROLLBACK_WINDOW > 2 * NET_MAX_PREDICTION, "NET_ROLLBACK_WINDOW must cover predicted frames on both peers");
+
+namespace {
+enum NetPacketType : Uint8 { NET_PACKET_HELLO = 1, NET_PACKET_WELCOME, NET_PACKET_INPUT };
+
+void writeU32(Uint8* out, Uint32 value) {
+    for (int i = 0; i < 4; i++) out[i] = static_cast<Uint8>(value >> (i * 8));
+}
+
+Uint32 readU32(const Uint8* in) {
+    Uint32 value = 0;
+    for (int i = 0; i < 4; i++) value |= static_cast<Uint32>(in[i]) << (i * 8);
+    return value;
+}
+}
+
+RollbackSession::RollbackSession() : role(NET_OFF), peer{0, 0}, connected(false), connectionPending(false), seed(0),
+    lastHelloMs(0), lastReceiveMs(0), finishMs(0) {
+    reset();
+}
+
+void RollbackSession::reset() {
+    memset(localInputs, 0, sizeof(localInputs));
+    memset(remoteInputs, 0, sizeof(remoteInputs));
+    memset(predictedInputs, 0, sizeof(predictedInputs));
+    localCount = 0;
+    remoteCount = 0;
+    peerAck = 0;
+    simulatedCount = 0;
+    rollbackFrame = -1;
+    for (int i = 0; i < NET_CHECKSUM_HISTORY; i++) checksumTicks[i] = -1;
+    memset(checksums, 0, sizeof(checksums));
+    latestChecksumTick = -1;
+    desynced = false;
+    rollbacks = 0;
+    deepestRollback = 0;
+}
+
+bool RollbackSession::host(Uint16 port) {
+    close();
+    if (!socket.open(port)) return false;
+    role = NET_HOST;
+    printf("Hosting co-op on UDP port %d, waiting for partner\n", port);
+    return true;
+}
+
+bool RollbackSession::join(const char* hostName, Uint16 port) {
+    close();
+    if (!socket.open(0)) return false;
+    if (!NetSocket::resolve(hostName, port, peer)) {
+        socket.close();
+        return false;
+    }
+    role = NET_GUEST;
+    printf("Joining co-op at %s:%d\n", hostName, port);
+    return true;
+}
+
+void RollbackSession::close() {
+    if (role == NET_OFF) return;
+    if (connected) printf("Co-op session closed: %d rollbacks, deepest %d frames\n", rollbacks, deepestRollback);
+    socket.close();
+    role = NET_OFF;
+    connected = false;
+    connectionPending = false;
+    finishMs = 0;
+    reset();
+}
+
+void RollbackSession::finish() {
+    if (!finishMs) finishMs = SDL_GetTicks() | 1;
+}
+
+bool RollbackSession::takeConnected() {
+    bool pending = connectionPending;
+    connectionPending = false;
+    return pending;
+}
+
+void RollbackSession::poll() {
+    if (role == NET_OFF) return;
+    socket.flush();
+    Uint8 packet[NET_MAX_PACKET];
+    NetAddress from;
+    int size;
+    while ((size = socket.receive(packet, sizeof(packet), from)) > 0) handlePacket(packet, size, from);
+    if (finishMs && SDL_GetTicks() - finishMs > NET_LINGER_MS) {
+        close();
+    } else if (connected && SDL_GetTicks() - lastReceiveMs > NET_TIMEOUT_MS) {
+        printf("Co-op partner timed out\n");
+        close();
+    }
+}
+
+void RollbackSession::handlePacket(const Uint8* data, int size, const NetAddress& from) {
+    if (role == NET_HOST && data[0] == NET_PACKET_HELLO && (!connected || (from.host == peer.host && from.port == peer.port))) {
+        if (!connected) {
+            peer = from;
+            seed = std::random_device()();
+            connected = true;
+            connectionPending = true;
+            lastReceiveMs = SDL_GetTicks();
+            printf("Co-op partner joined\n");
+        }
+        Uint8 welcome[5] = {NET_PACKET_WELCOME};
+        writeU32(welcome + 1, seed);
+        socket.send(peer, welcome, sizeof(welcome));
+        return;
+    }
+    if (from.host != peer.host || from.port != peer.port) return;
+    if (role == NET_GUEST && data[0] == NET_PACKET_WELCOME && size >= 5 && !connected) {
+        seed = readU32(data + 1);
+        connected = true;
+        connectionPending = true;
+        printf("Joined co-op session\n");
+    }
+    if (!connected) return;
+    lastReceiveMs = SDL_GetTicks();
+    if (data[0] == NET_PACKET_INPUT) handleInputs(data, size);
+}
+
+void RollbackSession::handleInputs(const Uint8* data, int size) {
+    if (size < 10) return;
+    int ack = static_cast<int>(readU32(data + 1));
+    int first = static_cast<int>(readU32(data + 5));
+    int count = data[9];
+    if (size < 18 + count) return;
+    peerAck = std::max(peerAck, std::min(ack, localCount));
+
+    Uint8 remoteMask = role == NET_HOST ? static_cast<Uint8>(~NET_HOST_INPUTS) : NET_HOST_INPUTS;
+    for (int i = 0; i < count; i++) {
+        int frame = first + i;
+        if (frame < remoteCount) continue;
+        if (frame > remoteCount || frame >= localCount + NET_MAX_PREDICTION) break;
+        Uint8 input = data[10 + i];
+        int slot = frame % NET_ROLLBACK_WINDOW;
+        remoteInputs[slot] = input;
+        if (frame < simulatedCount && ((input ^ predictedInputs[slot]) & remoteMask) &&
+            (rollbackFrame < 0 || frame < rollbackFrame)) {
+            rollbackFrame = frame;
+        }
+        remoteCount++;
+    }
+
+    int checksumTick = static_cast<int>(readU32(data + 10 + count));
+    Uint32 checksum = readU32(data + 14 + count);
+    for (int i = 0; i < NET_CHECKSUM_HISTORY && checksumTick > 0 && !desynced; i++) {
+        if (checksumTicks[i] == checksumTick && checksums[i] != checksum) {
+            printf("Co-op desync at tick %d\n", checksumTick);
+            desynced = true;
+        }
+    }
+}
+
+void RollbackSession::sendInputs() {
+    if (role == NET_OFF) return;
+    if (!connected) {
+        Uint32 now = SDL_GetTicks();
+        if (role == NET_GUEST && now - lastHelloMs >= NET_HELLO_INTERVAL_MS) {
+            Uint8 hello = NET_PACKET_HELLO;
+            socket.send(peer, &hello, 1);
+            lastHelloMs = now;
+        }
+        socket.flush();
+        return;
+    }
+    Uint8 packet[NET_MAX_PACKET];
+    int count = std::min(localCount - peerAck, NET_ROLLBACK_WINDOW);
+    int first = localCount - count;
+    packet[0] = NET_PACKET_INPUT;
+    writeU32(packet + 1, static_cast<Uint32>(remoteCount));
+    writeU32(packet + 5, static_cast<Uint32>(first));
+    packet[9] = static_cast<Uint8>(count);
+    for (int i = 0; i < count; i++) packet[10 + i] = localInputs[(first + i) % NET_ROLLBACK_WINDOW];
+    int slot = latestChecksumTick < 0 ? 0 : (latestChecksumTick / REPLAY_CHECKSUM_INTERVAL) % NET_CHECKSUM_HISTORY;
+    writeU32(packet + 10 + count, static_cast<Uint32>(latestChecksumTick < 0 ? 0 : latestChecksumTick));
+    writeU32(packet + 14 + count, checksums[slot]);
+    socket.send(peer, packet, 18 + count);
+    socket.flush();
+}
+
+bool RollbackSession::canAdvance(int frame) const {
+    return connected && frame == localCount && frame - remoteCount < NET_MAX_PREDICTION &&
+           frame - peerAck < NET_ROLLBACK_WINDOW;
+}
+
+void RollbackSession::addLocalInput(Uint8 input) {
+    localInputs[localCount % NET_ROLLBACK_WINDOW] = input;
+    localCount++;
+}
+
+Uint8 RollbackSession::getInput(int frame) {
+    int slot = frame % NET_ROLLBACK_WINDOW;
+    Uint8 remote;
+    if (frame < remoteCount) {
+        remote = remoteInputs[slot];
+    } else {
+        remote = remoteCount > 0 ? remoteInputs[(remoteCount - 1) % NET_ROLLBACK_WINDOW] : 0;
+        predictedInputs[slot] = remote;
+    }
+    simulatedCount = std::max(simulatedCount, frame + 1);
+    Uint8 local = localInputs[slot];
+    Uint8 hostInput = role == NET_HOST ? local : remote;
+    Uint8 guestInput = role == NET_HOST ? remote : local;
+    return (hostInput & NET_HOST_INPUTS) | (guestInput & ~NET_HOST_INPUTS);
+}
+
+int RollbackSession::takeRollbackFrame() {
+    int frame = rollbackFrame;
+    rollbackFrame = -1;
+    if (frame >= 0) {
+        rollbacks++;
+        deepestRollback = std::max(deepestRollback, simulatedCount - frame);
+    }
+    return frame;
+}
+
+void RollbackSession::recordChecksum(int tick, Uint32 checksum) {
+    int slot = (tick / REPLAY_CHECKSUM_INTERVAL) % NET_CHECKSUM_HISTORY;
+    checksumTicks[slot] = tick;
+    checksums[slot] = checksum;
+    latestChecksumTick = tick;
+}
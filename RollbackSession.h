@@ -0,0 +1,60 @@
+#ifndef ROLLBACK_SESSION_H
+#define ROLLBACK_SESSION_H
+#include <SDL.h>
+#include "Config.h"
+#include "NetSocket.h"
+
+class RollbackSession {
+public:
+    RollbackSession();
+    bool host(Uint16 port);
+    bool join(const char* hostName, Uint16 port);
+    void setConditions(int delayMs, int jitterMs, int lossPercent) { socket.setConditions(delayMs, jitterMs, lossPercent); }
+    void close();
+    void finish();
+    bool isActive() const { return role != NET_OFF; }
+    bool isConnected() const { return connected; }
+    NetRole getRole() const { return role; }
+    Uint32 getSeed() const { return seed; }
+    int getLocalFrames() const { return localCount; }
+    bool takeConnected();
+    void poll();
+    void sendInputs();
+    bool canAdvance(int frame) const;
+    void addLocalInput(Uint8 input);
+    Uint8 getInput(int frame);
+    bool isConfirmed(int frame) const { return frame < remoteCount; }
+    bool isSettled(int frameCount) const { return frameCount <= remoteCount && frameCount <= peerAck; }
+    int takeRollbackFrame();
+    void recordChecksum(int tick, Uint32 checksum);
+private:
+    void handlePacket(const Uint8* data, int size, const NetAddress& from);
+    void handleInputs(const Uint8* data, int size);
+    void reset();
+
+    NetSocket socket;
+    NetRole role;
+    NetAddress peer;
+    bool connected;
+    bool connectionPending;
+    Uint32 seed;
+    Uint32 lastHelloMs;
+    Uint32 lastReceiveMs;
+    Uint32 finishMs;
+    Uint8 localInputs[NET_ROLLBACK_WINDOW];
+    Uint8 remoteInputs[NET_ROLLBACK_WINDOW];
+    Uint8 predictedInputs[NET_ROLLBACK_WINDOW];
+    int localCount;
+    int remoteCount;
+    int peerAck;
+    int simulatedCount;
+    int rollbackFrame;
+    int checksumTicks[NET_CHECKSUM_HISTORY];
+    Uint32 checksums[NET_CHECKSUM_HISTORY];
+    int latestChecksumTick;
+    bool desynced;
+    int rollbacks;
+    int deepestRollback;
+};
+
+#endif
@@ -0,0 +1,275 @@
+#include "RunHistory.h"
+#include "Utils.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+const char LOG_MAGIC[4] = {'U', 'M', 'R', 'L'};
+const char INDEX_MAGIC[4] = {'U', 'M', 'R', 'I'};
+const Uint32 HISTORY_VERSION = 1;
+const Uint32 LOG_HEADER_SIZE = 8;
+const Uint32 LOG_ENTRY_SIZE = sizeof(RunRecord) + sizeof(Uint32);
+
+static_assert(sizeof(RunRecord) == 24, "RunRecord must stay a packed on-disk layout");
+
+void syncFile(FILE* file) {
+    fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+bool replaceFile(const char* from, const char* to) {
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(from, to) == 0;
+#endif
+}
+}
+
+RunHistory::RunHistory(const char* log, const char* index) :
+    logPath(log), indexPath(index), logBytes(0), stopping(false) {
+}
+
+RunHistory::~RunHistory() {
+    shutdown();
+}
+
+void RunHistory::load() {
+    FILE* file = fopen(logPath, "rb");
+    Uint32 fileBytes = 0;
+    if (file) {
+        fseek(file, 0, SEEK_END);
+        fileBytes = static_cast<Uint32>(ftell(file));
+        fclose(file);
+    }
+
+    if (fileBytes == 0) {
+        logBytes = 0;
+        importLegacyBestScore();
+    } else if (!loadIndex(fileBytes)) {
+        logBytes = scanLog();
+        writeIndex();
+    } else {
+        logBytes = fileBytes;
+    }
+    topRuns = ioTopRuns;
+
+    if (!worker.joinable()) {
+        stopping = false;
+        worker = std::thread(&RunHistory::ioLoop, this);
+    }
+}
+
+void RunHistory::submit(const RunRecord& record) {
+    insertTopRun(topRuns, record);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(record);
+    }
+    wake.notify_one();
+}
+
+void RunHistory::writeFileAsync(const std::string& path, std::vector<Uint8> bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingFiles.emplace_back(path, std::move(bytes));
+    }
+    wake.notify_one();
+}
+
+void RunHistory::shutdown() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void RunHistory::ioLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !pending.empty() || !pendingFiles.empty(); });
+        if (pending.empty() && pendingFiles.empty()) break;
+        std::deque<RunRecord> batch;
+        std::deque<std::pair<std::string, std::vector<Uint8>>> files;
+        batch.swap(pending);
+        files.swap(pendingFiles);
+        lock.unlock();
+        PROFILE_ZONE("RunHistory::ioBatch");
+        for (const auto& record : batch) {
+            if (appendToLog(record)) insertTopRun(ioTopRuns, record);
+        }
+        if (!batch.empty()) writeIndex();
+        for (const auto& file : files) {
+            if (!writeFileAtomic(file.first, file.second)) printf("Could not write %s\n", file.first.c_str());
+        }
+        lock.lock();
+    }
+}
+
+bool RunHistory::loadIndex(Uint32 expectedLogBytes) {
+    std::ifstream file(indexPath, std::ios::binary);
+    if (!file.is_open()) return false;
+    char magic[4];
+    Uint32 version = 0, indexedLogBytes = 0, count = 0, storedChecksum = 0;
+    file.read(magic, 4);
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&indexedLogBytes), sizeof(indexedLogBytes));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!file || memcmp(magic, INDEX_MAGIC, 4) != 0 || version != HISTORY_VERSION ||
+        indexedLogBytes != expectedLogBytes || count > static_cast<Uint32>(RUN_HISTORY_TOP_COUNT)) return false;
+
+    std::vector<RunRecord> runs(count);
+    if (count > 0) file.read(reinterpret_cast<char*>(runs.data()), count * sizeof(RunRecord));
+    file.read(reinterpret_cast<char*>(&storedChecksum), sizeof(storedChecksum));
+    if (!file) return false;
+    Uint32 header[3] = {version, indexedLogBytes, count};
+    Uint32 hash = hashBytes(header, sizeof(header));
+    if (count > 0) hash = hashBytes(runs.data(), count * sizeof(RunRecord), hash);
+    if (hash != storedChecksum) return false;
+
+    ioTopRuns = runs;
+    return true;
+}
+
+Uint32 RunHistory::scanLog() {
+    ioTopRuns.clear();
+    std::ifstream file(logPath, std::ios::binary);
+    char magic[4];
+    Uint32 version = 0;
+    file.read(magic, 4);
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!file || memcmp(magic, LOG_MAGIC, 4) != 0 || version != HISTORY_VERSION) {
+        printf("Run history log is unreadable, starting a new one.\n");
+        std::remove(logPath);
+        return 0;
+    }
+
+    std::vector<RunRecord> valid;
+    RunRecord record;
+    Uint32 storedChecksum;
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record)) &&
+           file.read(reinterpret_cast<char*>(&storedChecksum), sizeof(storedChecksum))) {
+        if (hashBytes(&record, sizeof(record)) != storedChecksum) break;
+        valid.push_back(record);
+        insertTopRun(ioTopRuns, record);
+    }
+    file.close();
+
+    Uint32 validBytes = LOG_HEADER_SIZE + static_cast<Uint32>(valid.size()) * LOG_ENTRY_SIZE;
+    FILE* check = fopen(logPath, "rb");
+    Uint32 fileBytes = 0;
+    if (check) {
+        fseek(check, 0, SEEK_END);
+        fileBytes = static_cast<Uint32>(ftell(check));
+        fclose(check);
+    }
+    if (fileBytes == validBytes) return validBytes;
+
+    printf("Run history log has a torn tail, keeping %d records.\n", static_cast<int>(valid.size()));
+    std::string tempPath = std::string(logPath) + ".tmp";
+    FILE* out = fopen(tempPath.c_str(), "wb");
+    if (!out) return validBytes;
+    fwrite(LOG_MAGIC, 1, 4, out);
+    fwrite(&HISTORY_VERSION, sizeof(HISTORY_VERSION), 1, out);
+    for (const auto& entry : valid) {
+        Uint32 hash = hashBytes(&entry, sizeof(entry));
+        fwrite(&entry, sizeof(entry), 1, out);
+        fwrite(&hash, sizeof(hash), 1, out);
+    }
+    syncFile(out);
+    fclose(out);
+    replaceFile(tempPath.c_str(), logPath);
+    return validBytes;
+}
+
+void RunHistory::importLegacyBestScore() {
+    ioTopRuns.clear();
+    std::ifstream file(LEGACY_BEST_SCORE_PATH);
+    int legacyScore = 0;
+    if (!file.is_open() || !(file >> legacyScore) || legacyScore <= 0) return;
+    RunRecord record = {0, legacyScore, 0, legacyScore * 10, DEATH_UNKNOWN, 0};
+    if (appendToLog(record)) {
+        insertTopRun(ioTopRuns, record);
+        writeIndex();
+    }
+}
+
+bool RunHistory::appendToLog(const RunRecord& record) {
+    // Write at logBytes rather than appending, so bytes left behind by a failed write get overwritten
+    // instead of sitting between records where scanLog would stop reading.
+    FILE* file = fopen(logPath, logBytes == 0 ? "wb" : "r+b");
+    if (!file) {
+        printf("Could not open run history log %s\n", logPath);
+        return false;
+    }
+    bool ok = true;
+    if (logBytes == 0) {
+        ok = fwrite(LOG_MAGIC, 1, 4, file) == 4 && fwrite(&HISTORY_VERSION, sizeof(HISTORY_VERSION), 1, file) == 1;
+    } else {
+        ok = fseek(file, static_cast<long>(logBytes), SEEK_SET) == 0;
+    }
+    RunRecord stamped = record;
+    if (stamped.timestamp == 0) stamped.timestamp = static_cast<Uint32>(time(nullptr));
+    Uint32 hash = hashBytes(&stamped, sizeof(stamped));
+    ok = ok && fwrite(&stamped, sizeof(stamped), 1, file) == 1 && fwrite(&hash, sizeof(hash), 1, file) == 1 &&
+         fflush(file) == 0;
+    syncFile(file);
+    ok = fclose(file) == 0 && ok;
+    if (ok) logBytes = std::max(logBytes, LOG_HEADER_SIZE) + LOG_ENTRY_SIZE;
+    else printf("Could not write run history log %s\n", logPath);
+    return ok;
+}
+
+bool RunHistory::writeIndex() {
+    std::string tempPath = std::string(indexPath) + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) return false;
+    Uint32 header[3] = {HISTORY_VERSION, logBytes, static_cast<Uint32>(ioTopRuns.size())};
+    Uint32 hash = hashBytes(header, sizeof(header));
+    if (!ioTopRuns.empty()) hash = hashBytes(ioTopRuns.data(), ioTopRuns.size() * sizeof(RunRecord), hash);
+    fwrite(INDEX_MAGIC, 1, 4, file);
+    fwrite(header, sizeof(header), 1, file);
+    if (!ioTopRuns.empty()) fwrite(ioTopRuns.data(), sizeof(RunRecord), ioTopRuns.size(), file);
+    fwrite(&hash, sizeof(hash), 1, file);
+    syncFile(file);
+    fclose(file);
+    return replaceFile(tempPath.c_str(), indexPath);
+}
+
+bool RunHistory::writeFileAtomic(const std::string& path, const std::vector<Uint8>& bytes) {
+    std::string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) return false;
+    bool ok = bytes.empty() || fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    syncFile(file);
+    fclose(file);
+    return ok && replaceFile(tempPath.c_str(), path.c_str());
+}
+
+void RunHistory::insertTopRun(std::vector<RunRecord>& runs, const RunRecord& record) {
+    auto it = std::upper_bound(runs.begin(), runs.end(), record,
+        [](const RunRecord& a, const RunRecord& b) { return a.score > b.score; });
+    if (it - runs.begin() >= RUN_HISTORY_TOP_COUNT) return;
+    runs.insert(it, record);
+    if (static_cast<int>(runs.size()) > RUN_HISTORY_TOP_COUNT) runs.pop_back();
+}
@@ -0,0 +1,56 @@
+#ifndef RUN_HISTORY_H
+#define RUN_HISTORY_H
+#include <SDL.h>
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Config.h"
+
+enum DeathCause { DEATH_UNKNOWN, DEATH_ENEMY, DEATH_ENEMY_BULLET, DEATH_SPIKES, DEATH_FALL };
+
+struct RunRecord {
+    Uint32 seed;
+    Sint32 score;
+    Uint32 durationTicks;
+    Sint32 distance;
+    Uint32 cause;
+    Uint32 timestamp;
+};
+
+class RunHistory {
+public:
+    RunHistory(const char* logPath, const char* indexPath);
+    ~RunHistory();
+    void load();
+    void submit(const RunRecord& record);
+    void writeFileAsync(const std::string& path, std::vector<Uint8> bytes);
+    void shutdown();
+    const std::vector<RunRecord>& getTopRuns() const { return topRuns; }
+    int getBestScore() const { return topRuns.empty() ? 0 : topRuns.front().score; }
+private:
+    void ioLoop();
+    bool loadIndex(Uint32 expectedLogBytes);
+    Uint32 scanLog();
+    void importLegacyBestScore();
+    bool appendToLog(const RunRecord& record);
+    bool writeIndex();
+    static bool writeFileAtomic(const std::string& path, const std::vector<Uint8>& bytes);
+    static void insertTopRun(std::vector<RunRecord>& runs, const RunRecord& record);
+
+    const char* logPath;
+    const char* indexPath;
+    std::vector<RunRecord> topRuns;
+    std::vector<RunRecord> ioTopRuns;
+    Uint32 logBytes;
+    std::deque<RunRecord> pending;
+    std::deque<std::pair<std::string, std::vector<Uint8>>> pendingFiles;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+};
+
+#endif
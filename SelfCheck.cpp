@@ -0,0 +1,112 @@
+#include "Game.h"
+#include "EnvPool.h"
+#include "RenderBench.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+bool reportCheck(const char* name, bool passed) {
+    printf("%-48s %s\n", name, passed ? "(ok)" : "(FAILED)");
+    return passed;
+}
+
+bool checkReusedEnv() {
+    EnvPool pool(2, 1);
+    EnvObservation observations[2];
+    float rewards[2];
+    Uint8 dones[2] = {0, 0};
+    Uint8 actions[2];
+    pool.reset(0, SELF_CHECK_SEED, &observations[0]);
+    for (int tick = 0; tick < SELF_CHECK_TICKS && !dones[0]; tick++) {
+        actions[0] = actions[1] = RenderBench::scriptedInput(tick);
+        pool.step(actions, observations, rewards, dones);
+    }
+
+    // Env 0 has played an episode, env 1 is fresh; the same seed must give the same episode.
+    pool.reset(0, SELF_CHECK_SEED + 3, &observations[0]);
+    pool.reset(1, SELF_CHECK_SEED + 3, &observations[1]);
+    if (memcmp(&observations[0], &observations[1], sizeof(EnvObservation)) != 0) return false;
+    dones[0] = dones[1] = 0;
+    for (int tick = 0; tick < SELF_CHECK_TICKS && !dones[0]; tick++) {
+        actions[0] = actions[1] = RenderBench::scriptedInput(tick);
+        pool.step(actions, observations, rewards, dones);
+        if (memcmp(&observations[0], &observations[1], sizeof(EnvObservation)) != 0 ||
+            rewards[0] != rewards[1] || dones[0] != dones[1]) return false;
+    }
+    return true;
+}
+}
+
+int Game::runSelfChecks() {
+    int failed = 0;
+    if (!reportCheck("replay recorded after Play Again plays back", checkSecondRunReplay())) failed++;
+    if (!reportCheck("net peers with different history stay in sync", checkNetPeersAgree())) failed++;
+    if (!reportCheck("reused env repeats a fresh env's episode", checkReusedEnv())) failed++;
+    if (!reportCheck("unjumpable pit chunk gets patched", checkPitChunkPatched())) failed++;
+    printf("Self checks: %d failed\n", failed);
+    return failed == 0 ? 0 : 1;
+}
+
+void Game::playScriptedRun(int ticks) {
+    for (int tick = 0; tick < ticks && gameState == PLAYING; tick++) {
+        heldInput = RenderBench::scriptedInput(tick);
+        simulateTick();
+    }
+}
+
+bool Game::checkSecondRunReplay() {
+    Game recorder(true);
+    recorder.resetGame(SELF_CHECK_SEED);
+    recorder.gameState = PLAYING;
+    recorder.playScriptedRun(SELF_CHECK_TICKS);
+
+    // The second run starts with the player wherever the first one ended, exactly like "Play Again".
+    recorder.resetGame(SELF_CHECK_SEED + 1);
+    recorder.gameState = PLAYING;
+    recorder.replay.beginRecording(recorder.runSeed);
+    recorder.playScriptedRun(SELF_CHECK_TICKS);
+
+    Game player(true);
+    player.replay = recorder.replay;
+    player.replayMode = REPLAY_FAST;
+    player.resetGame(player.replay.getSeed());
+    player.gameState = PLAYING;
+    while (player.gameState == PLAYING && player.replay.hasInput()) player.simulateTick();
+    return player.replayDesyncTick < 0 && player.simulationTick == recorder.simulationTick;
+}
+
+bool Game::checkNetPeersAgree() {
+    Game host(true);
+    Game guest(true);
+    guest.resetGame(SELF_CHECK_SEED);
+    guest.gameState = PLAYING;
+    guest.playScriptedRun(SELF_CHECK_TICKS);
+
+    // Both peers reset to the shared session seed the way simulateNetTick does once connected.
+    host.resetGame(SELF_CHECK_SEED + 2);
+    guest.resetGame(SELF_CHECK_SEED + 2);
+    host.gameState = PLAYING;
+    guest.gameState = PLAYING;
+    for (int tick = 0; tick < SELF_CHECK_TICKS && host.gameState == PLAYING; tick++) {
+        Uint8 input = RenderBench::scriptedInput(tick);
+        host.applyInput(input);
+        host.update();
+        guest.applyInput(input);
+        guest.update();
+        if (host.simulationTick % REPLAY_CHECKSUM_INTERVAL == 0 && host.stateChecksum() != guest.stateChecksum()) return false;
+    }
+    return true;
+}
+
+bool Game::checkPitChunkPatched() {
+    Game game(true);
+    int pitLeft = TILE_SIZE * SELF_CHECK_LEDGE_TILES;
+    game.lastGeneratedX = pitLeft + TILE_SIZE * SELF_CHECK_PIT_TILES;
+    for (int x = 0; x < pitLeft; x += TILE_SIZE) game.addTile({x, game.groundHeight, TILE_SIZE, TILE_SIZE}, true);
+
+    // A ledge followed by a pit wider than any jump: the raw chunk must fail, the patched one must pass.
+    if (game.reachability.check(*game.terrain, 0, game.lastGeneratedX, game.chunkExitY())) return false;
+    game.validateChunk(0);
+    return game.reachStats.patched == 1 && game.reachStats.failed == 0 &&
+           game.reachability.check(*game.terrain, 0, game.lastGeneratedX, game.chunkExitY());
+}
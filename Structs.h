@@ -1,7 +1,7 @@
 #ifndef STRUCTS_H
 #define STRUCTS_H
 #include <SDL.h>
-#include <string>
+#include "Fixed.h"
 
 struct Tile {
     SDL_Rect rect;
@@ -10,27 +10,52 @@ struct Tile {
 
 struct Button {
     SDL_Rect rect;
-    std::string text;
+    const char* text;
 };
 
-struct Bullet {
+struct Projectile {
     SDL_Rect rect;
-    float speed;
-    bool active;
-    bool facingLeft;
-    int distanceTraveled;
+    Fixed positionX;
+    Fixed positionY;
+    Fixed velocityX;
+    Fixed velocityY;
+    Fixed gravity;
     int startX;
+    Uint8 team;
+    bool active;
 };
 
 struct Enemy {
     SDL_Rect rect;
-    float speed;
+    Fixed positionX;
+    Fixed positionY;
     bool active;
     bool facingLeft;
     int type;
     int shootCooldown;
-    float detectionRange;
-    float velocityY;
+    int detectionRange;
+    Fixed velocityX;
+    Fixed velocityY;
+    int updateSlot;
+    int pendingTicks;
+    int sightTick;
+    bool hasSight;
+    int navNode;
+    int navEdge;
+    int navSlot;
+};
+
+struct EnvObservation {
+    Sint32 playerX;
+    Sint32 playerY;
+    Fixed velocityX;
+    Fixed velocityY;
+    Sint32 lives;
+    Sint32 enemyDX;
+    Sint32 enemyDY;
+    Sint32 bulletDX;
+    Sint32 bulletDY;
+    Uint32 groundAhead;
 };
 
 #endif
@@ -0,0 +1,229 @@
+#include "TerrainProfile.h"
+#include "Utils.h"
+#include <algorithm>
+
+TerrainProfile::TerrainProfile() : firstSlot(0), columnCount(0), baseColumn(0) {
+}
+
+void TerrainProfile::clear() {
+    for (auto& spans : columns) spans.clear();
+    firstSlot = 0;
+    columnCount = 0;
+    baseColumn = 0;
+}
+
+void TerrainProfile::rebuild(const std::vector<Tile>& tiles) {
+    clear();
+    for (const auto& tile : tiles) addTile(tile.rect);
+}
+
+int TerrainProfile::columnOf(int x) {
+    return x >= 0 ? x / TILE_SIZE : -((-x + TILE_SIZE - 1) / TILE_SIZE);
+}
+
+const std::vector<TerrainSpan>* TerrainProfile::column(int index) const {
+    int offset = index - baseColumn;
+    if (offset < 0 || offset >= columnCount) return nullptr;
+    return &columns[(firstSlot + offset) % columns.size()];
+}
+
+std::vector<TerrainSpan>& TerrainProfile::slot(int offset) {
+    return columns[(firstSlot + offset) % columns.size()];
+}
+
+void TerrainProfile::grow() {
+    std::vector<std::vector<TerrainSpan>> grown(std::max<size_t>(columns.size() * 2, TERRAIN_RESERVE_COLUMNS));
+    for (int i = 0; i < columnCount; i++) grown[i].swap(slot(i));
+    columns.swap(grown);
+    firstSlot = 0;
+}
+
+void TerrainProfile::addTile(const SDL_Rect& rect) {
+    int first = columnOf(rect.x);
+    int last = columnOf(rect.x + rect.w - 1);
+    if (columnCount == 0) baseColumn = first;
+    while (first < baseColumn) {
+        if (columnCount == static_cast<int>(columns.size())) grow();
+        firstSlot = (firstSlot + columns.size() - 1) % columns.size();
+        slot(0).clear();
+        columnCount++;
+        baseColumn--;
+    }
+    while (baseColumn + columnCount <= last) {
+        if (columnCount == static_cast<int>(columns.size())) grow();
+        slot(columnCount++).clear();
+    }
+
+    TerrainSpan span = {rect.x, rect.x + rect.w, rect.y, rect.y + rect.h};
+    for (int c = first; c <= last; c++) {
+        std::vector<TerrainSpan>& spans = slot(c - baseColumn);
+        auto it = std::lower_bound(spans.begin(), spans.end(), span,
+            [](const TerrainSpan& a, const TerrainSpan& b) { return a.top < b.top; });
+        if (it != spans.begin()) {
+            TerrainSpan& above = *(it - 1);
+            if (above.left == span.left && above.right == span.right && above.bottom == span.top) {
+                above.bottom = span.bottom;
+                if (it != spans.end() && it->left == span.left && it->right == span.right && it->top == above.bottom) {
+                    above.bottom = it->bottom;
+                    spans.erase(it);
+                }
+                continue;
+            }
+        }
+        if (it != spans.end() && it->left == span.left && it->right == span.right && it->top == span.bottom) {
+            it->top = span.top;
+            continue;
+        }
+        spans.insert(it, span);
+    }
+}
+
+void TerrainProfile::evictBefore(int x) {
+    for (int i = 0; i < columnCount && (baseColumn + i) * TILE_SIZE < x; i++) {
+        std::vector<TerrainSpan>& spans = slot(i);
+        spans.erase(std::remove_if(spans.begin(), spans.end(),
+            [x](const TerrainSpan& span) { return span.right < x; }), spans.end());
+    }
+    while (columnCount > 0 && slot(0).empty() && baseColumn * TILE_SIZE < x) {
+        firstSlot = (firstSlot + 1) % columns.size();
+        columnCount--;
+        baseColumn++;
+    }
+}
+
+bool TerrainProfile::isSolidAt(int x, int y) const {
+    const std::vector<TerrainSpan>* spans = column(columnOf(x));
+    if (!spans) return false;
+    for (const auto& span : *spans) {
+        if (span.top > y) break;
+        if (y < span.bottom && x >= span.left && x < span.right) return true;
+    }
+    return false;
+}
+
+bool TerrainProfile::overlaps(const SDL_Rect& rect) const {
+    int last = columnOf(rect.x + rect.w - 1);
+    for (int c = columnOf(rect.x); c <= last; c++) {
+        const std::vector<TerrainSpan>* spans = column(c);
+        if (!spans) continue;
+        for (const auto& span : *spans) {
+            if (span.top >= rect.y + rect.h) break;
+            SDL_Rect spanRect = {span.left, span.top, span.right - span.left, span.bottom - span.top};
+            if (checkCollision(rect, spanRect)) return true;
+        }
+    }
+    return false;
+}
+
+bool TerrainProfile::findSurface(int left, int right, int minY, int maxY, int& surfaceY) const {
+    bool found = false;
+    int last = columnOf(right);
+    for (int c = columnOf(left - 1); c <= last; c++) {
+        const std::vector<TerrainSpan>* spans = column(c);
+        if (!spans) continue;
+        for (const auto& span : *spans) {
+            if (span.top > maxY || (found && span.top >= surfaceY)) break;
+            if (span.top >= minY && span.left <= right && span.right >= left) {
+                surfaceY = span.top;
+                found = true;
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+void TerrainProfile::findSurfaces(int left, int right, int clearance, std::vector<TerrainSpan>& surfaces) const {
+    surfaces.clear();
+    int last = columnOf(right - 1);
+    for (int c = columnOf(left); c <= last; c++) {
+        const std::vector<TerrainSpan>* spans = column(c);
+        if (!spans) continue;
+        for (const auto& span : *spans) {
+            if (span.left < left || span.left >= right || columnOf(span.left) != c || span.top < clearance) continue;
+            SDL_Rect room = {span.left, span.top - clearance, span.right - span.left, clearance};
+            if (!overlaps(room)) surfaces.push_back({span.left, span.right, span.top, span.top});
+        }
+    }
+    std::sort(surfaces.begin(), surfaces.end(), [](const TerrainSpan& a, const TerrainSpan& b) {
+        return a.top != b.top ? a.top < b.top : a.left < b.left;
+    });
+    size_t merged = 0;
+    for (size_t i = 0; i < surfaces.size(); i++) {
+        if (merged > 0 && surfaces[merged - 1].top == surfaces[i].top && surfaces[i].left <= surfaces[merged - 1].right) {
+            surfaces[merged - 1].right = std::max(surfaces[merged - 1].right, surfaces[i].right);
+        } else {
+            surfaces[merged++] = surfaces[i];
+        }
+    }
+    surfaces.resize(merged);
+}
+
+bool TerrainProfile::findCeiling(int left, int right, int maxY, int& ceilingY) const {
+    bool found = false;
+    int last = columnOf(right - 1);
+    for (int c = columnOf(left); c <= last; c++) {
+        const std::vector<TerrainSpan>* spans = column(c);
+        if (!spans) continue;
+        for (const auto& span : *spans) {
+            if (span.top >= maxY) break;
+            if (span.bottom <= maxY && span.left < right && span.right > left && (!found || span.bottom > ceilingY)) {
+                ceilingY = span.bottom;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+bool TerrainProfile::cellBlocked(int columnIndex, int row, int x0, int y0, int x1, int y1) const {
+    const std::vector<TerrainSpan>* spans = column(columnIndex);
+    if (!spans) return false;
+    int left = std::max(columnIndex * TILE_SIZE, std::min(x0, x1));
+    int top = std::max(row * TILE_SIZE, std::min(y0, y1));
+    int right = std::min((columnIndex + 1) * TILE_SIZE, std::max(x0, x1));
+    int bottom = std::min((row + 1) * TILE_SIZE, std::max(y0, y1));
+    long long dx = x1 - x0;
+    long long dy = y1 - y0;
+    for (const auto& span : *spans) {
+        if (span.top > bottom) break;
+        int spanLeft = std::max(left, span.left);
+        int spanTop = std::max(top, span.top);
+        int spanRight = std::min(right, span.right);
+        int spanBottom = std::min(bottom, span.bottom);
+        if (spanLeft > spanRight || spanTop > spanBottom) continue;
+        int corners[4][2] = {{spanLeft, spanTop}, {spanRight, spanTop}, {spanLeft, spanBottom}, {spanRight, spanBottom}};
+        int above = 0, below = 0;
+        for (const auto& corner : corners) {
+            long long side = dx * (corner[1] - y0) - dy * (corner[0] - x0);
+            if (side >= 0) above++;
+            if (side <= 0) below++;
+        }
+        if (above > 0 && below > 0) return true;
+    }
+    return false;
+}
+
+bool TerrainProfile::hasLineOfSight(int x0, int y0, int x1, int y1) const {
+    int columnIndex = columnOf(x0);
+    int row = columnOf(y0);
+    int lastColumn = columnOf(x1);
+    int lastRow = columnOf(y1);
+    int stepX = x1 >= x0 ? 1 : -1;
+    int stepY = y1 >= y0 ? 1 : -1;
+    long long dx = std::abs(x1 - x0);
+    long long dy = std::abs(y1 - y0);
+    long long toBoundaryX = stepX > 0 ? (columnIndex + 1) * TILE_SIZE - x0 : x0 - columnIndex * TILE_SIZE;
+    long long toBoundaryY = stepY > 0 ? (row + 1) * TILE_SIZE - y0 : y0 - row * TILE_SIZE;
+    while (true) {
+        if (cellBlocked(columnIndex, row, x0, y0, x1, y1)) return false;
+        if (columnIndex == lastColumn && row == lastRow) return true;
+        if (row == lastRow || (columnIndex != lastColumn && toBoundaryX * dy <= toBoundaryY * dx)) {
+            columnIndex += stepX;
+            toBoundaryX += TILE_SIZE;
+        } else {
+            row += stepY;
+            toBoundaryY += TILE_SIZE;
+        }
+    }
+}
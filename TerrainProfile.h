@@ -0,0 +1,41 @@
+#ifndef TERRAIN_PROFILE_H
+#define TERRAIN_PROFILE_H
+#include <SDL.h>
+#include <vector>
+#include "Structs.h"
+#include "Config.h"
+
+struct TerrainSpan {
+    int left;
+    int right;
+    int top;
+    int bottom;
+};
+
+class TerrainProfile {
+public:
+    TerrainProfile();
+    void clear();
+    void rebuild(const std::vector<Tile>& tiles);
+    void addTile(const SDL_Rect& rect);
+    void evictBefore(int x);
+    bool isSolidAt(int x, int y) const;
+    bool overlaps(const SDL_Rect& rect) const;
+    bool findSurface(int left, int right, int minY, int maxY, int& surfaceY) const;
+    bool hasLineOfSight(int x0, int y0, int x1, int y1) const;
+    void findSurfaces(int left, int right, int clearance, std::vector<TerrainSpan>& surfaces) const;
+    bool findCeiling(int left, int right, int maxY, int& ceilingY) const;
+private:
+    static int columnOf(int x);
+    bool cellBlocked(int column, int row, int x0, int y0, int x1, int y1) const;
+    const std::vector<TerrainSpan>* column(int index) const;
+    std::vector<TerrainSpan>& slot(int offset);
+    void grow();
+
+    std::vector<std::vector<TerrainSpan>> columns;
+    int firstSlot;
+    int columnCount;
+    int baseColumn;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include "TextCache.h"
+#include "Utils.h"
+#include <cstdio>
+#include <cstring>
+
+TextCache::TextCache() : renderer(nullptr), entries(), frame(0) {
+}
+
+void TextCache::create(SDL_Renderer* sdlRenderer) {
+    destroy();
+    renderer = sdlRenderer;
+}
+
+void TextCache::destroy() {
+    for (auto& entry : entries) {
+        if (entry.texture) SDL_DestroyTexture(entry.texture);
+        entry = TextCacheEntry();
+    }
+}
+
+void TextCache::nextFrame() {
+    frame++;
+    for (auto& entry : entries) {
+        if (entry.texture && frame - entry.lastUsedFrame > TEXT_CACHE_EVICT_FRAMES) {
+            SDL_DestroyTexture(entry.texture);
+            entry = TextCacheEntry();
+        }
+    }
+}
+
+SDL_Texture* TextCache::get(const char* text, SDL_Color color, TTF_Font* font, int& width, int& height) {
+    size_t length = strlen(text);
+    if (length >= sizeof(entries[0].text)) {
+        printf("Text too long to cache: %s\n", text);
+        return nullptr;
+    }
+    Uint32 hash = hashBytes(text, length);
+    TextCacheEntry* victim = &entries[0];
+    for (auto& entry : entries) {
+        if (entry.texture && entry.hash == hash && entry.font == font && strcmp(entry.text, text) == 0 &&
+            memcmp(&entry.color, &color, sizeof(color)) == 0) {
+            entry.lastUsedFrame = frame;
+            width = entry.width;
+            height = entry.height;
+            return entry.texture;
+        }
+        if (!entry.texture) victim = &entry;
+        else if (victim->texture && entry.lastUsedFrame < victim->lastUsedFrame) victim = &entry;
+    }
+
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
+    if (!surface) return nullptr;
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    width = surface->w;
+    height = surface->h;
+    SDL_FreeSurface(surface);
+    if (!texture) return nullptr;
+
+    if (victim->texture) SDL_DestroyTexture(victim->texture);
+    victim->font = font;
+    victim->color = color;
+    victim->hash = hash;
+    memcpy(victim->text, text, length + 1);
+    victim->texture = texture;
+    victim->width = width;
+    victim->height = height;
+    victim->lastUsedFrame = frame;
+    return texture;
+}
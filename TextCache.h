@@ -0,0 +1,31 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "Config.h"
+
+struct TextCacheEntry {
+    TTF_Font* font;
+    SDL_Color color;
+    Uint32 hash;
+    char text[TEXT_CACHE_MAX_LENGTH];
+    SDL_Texture* texture;
+    int width;
+    int height;
+    int lastUsedFrame;
+};
+
+class TextCache {
+public:
+    TextCache();
+    void create(SDL_Renderer* renderer);
+    void destroy();
+    void nextFrame();
+    SDL_Texture* get(const char* text, SDL_Color color, TTF_Font* font, int& width, int& height);
+private:
+    SDL_Renderer* renderer;
+    TextCacheEntry entries[TEXT_CACHE_SIZE];
+    int frame;
+};
+
+#endif
@@ -3,3 +3,9 @@
 bool checkCollision(const SDL_Rect& a, const SDL_Rect& b) {
     return (a.x < b.x + b.w && a.x + a.w > b.x && a.y < b.y + b.h && a.y + a.h > b.y);
 }
+
+Uint32 hashBytes(const void* data, size_t size, Uint32 hash) {
+    const Uint8* bytes = static_cast<const Uint8*>(data);
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
@@ -1,7 +1,9 @@
 #ifndef UTILS_H
 #define UTILS_H
 #include <SDL.h>
+#include <cstddef>
 
 bool checkCollision(const SDL_Rect& a, const SDL_Rect& b);
+Uint32 hashBytes(const void* data, size_t size, Uint32 hash = 2166136261u);
 
 #endif
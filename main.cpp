@@ -1,8 +1,68 @@
 #include "Game.h"
+#include <cstring>
+#include <cstdlib>
 
 int main(int argc, char* args[]) {
+    const char* replayPath = nullptr;
+    ReplayMode replayMode = REPLAY_REALTIME;
+    int seekTick = 0;
+    bool selfCheck = false;
+    bool renderBench = false;
+    bool updateGolden = false;
+    bool perfBench = false;
+    bool perfRender = true;
+    bool updateBaseline = false;
+    const char* baselinePath = PERF_BASELINE_PATH;
+    const char* goldenDir = RENDER_GOLDEN_DIR;
+    int frameRate = FRAME_TARGET_RATE;
+    bool threadedRendering = true;
+    bool netHost = false;
+    char joinHost[256] = "";
+    int netPort = NET_DEFAULT_PORT;
+    int netDelay = 0, netJitter = 0, netLoss = 0;
+    int validateSeeds = 0;
+    int validateChunks = REACH_BATCH_CHUNKS;
+    Uint32 seedBase = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(args[i], "--replay") == 0 && i + 1 < argc) replayPath = args[++i];
+        else if (strcmp(args[i], "--fast") == 0) replayMode = REPLAY_FAST;
+        else if (strcmp(args[i], "--seek") == 0 && i + 1 < argc) seekTick = atoi(args[++i]);
+        else if (strcmp(args[i], "--self-check") == 0) selfCheck = true;
+        else if (strcmp(args[i], "--render-bench") == 0) renderBench = true;
+        else if (strcmp(args[i], "--golden") == 0 && i + 1 < argc) goldenDir = args[++i];
+        else if (strcmp(args[i], "--update-golden") == 0) updateGolden = true;
+        else if (strcmp(args[i], "--perf-bench") == 0) perfBench = true;
+        else if (strcmp(args[i], "--perf-sim-only") == 0) perfRender = false;
+        else if (strcmp(args[i], "--baseline") == 0 && i + 1 < argc) baselinePath = args[++i];
+        else if (strcmp(args[i], "--update-baseline") == 0) updateBaseline = true;
+        else if (strcmp(args[i], "--fps") == 0 && i + 1 < argc) frameRate = atoi(args[++i]);
+        else if (strcmp(args[i], "--single-thread") == 0) threadedRendering = false;
+        else if (strcmp(args[i], "--host") == 0 && i + 1 < argc) { netHost = true; netPort = atoi(args[++i]); }
+        else if (strcmp(args[i], "--join") == 0 && i + 1 < argc) {
+            strncpy(joinHost, args[++i], sizeof(joinHost) - 1);
+            char* separator = strchr(joinHost, ':');
+            if (separator) { *separator = '\0'; netPort = atoi(separator + 1); }
+        }
+        else if (strcmp(args[i], "--net-delay") == 0 && i + 1 < argc) netDelay = atoi(args[++i]);
+        else if (strcmp(args[i], "--net-jitter") == 0 && i + 1 < argc) netJitter = atoi(args[++i]);
+        else if (strcmp(args[i], "--net-loss") == 0 && i + 1 < argc) netLoss = atoi(args[++i]);
+        else if (strcmp(args[i], "--validate-seeds") == 0 && i + 1 < argc) validateSeeds = atoi(args[++i]);
+        else if (strcmp(args[i], "--validate-chunks") == 0 && i + 1 < argc) validateChunks = atoi(args[++i]);
+        else if (strcmp(args[i], "--seed-base") == 0 && i + 1 < argc) seedBase = static_cast<Uint32>(strtoul(args[++i], nullptr, 10));
+    }
+    if (selfCheck) return Game::runSelfChecks();
+    if (validateSeeds > 0) return Game::runReachabilityBatch(seedBase, validateSeeds, validateChunks);
+
     Game game;
-    if (!game.init()) return 1;
+    game.setFrameRate(frameRate);
+    game.setThreadedRendering(threadedRendering);
+    if (!game.init(renderBench || perfBench)) return 1;
+    if (renderBench) return game.runRenderBenchmark(replayPath, goldenDir, updateGolden);
+    if (perfBench) return game.runPerfBenchmark(replayPath, perfRender, baselinePath, updateBaseline);
+    if (replayPath && !game.startReplay(replayPath, replayMode, seekTick)) return 1;
+    if ((netHost || joinHost[0]) &&
+        !game.startNetPlay(joinHost[0] ? joinHost : nullptr, static_cast<Uint16>(netPort), netDelay, netJitter, netLoss)) return 1;
+
     game.run();
     return 0;
 }